@@ -0,0 +1,756 @@
+/*
+ * Host benchmark for the FIFO buffers and the UART message layer.
+ *
+ * Measures throughput and per-operation latency of FIFO_Push(), FIFO_Pop(), FIFO_Peek()
+ * and FIFO_PushOverwrite() (out-of-line and inlined, power-of-two and other sizes),
+ * Add_UART_Message(), Get_UART_Message() and Get_UART_MessageView() frames per second
+ * across message and buffer sizes, resynchronization after line noise, FIFO_FindByte()
+ * and the XOR checksum with each SIMD level, the CRC-16 and CRC-32C kernels, and the
+ * threaded SPSC, MPSC and MPMC queues. Results are written to stdout as one JSON
+ * document so runs can be stored and compared.
+ *
+ * Build and run on Linux from the repository root:
+ *
+ *   gcc -std=c11 -O2 -pthread -I. benchmarks/fifo_bench.c fifo_buffer.c fifo_simd.c \
+ *       fifo_crc.c uart_message_fifo.c fifo_spsc.c fifo_mpsc.c fifo_mpmc.c -o fifo_bench
+ *   ./fifo_bench [scale] > results.json
+ *
+ * `scale` multiplies every iteration count (default 1.0, e.g. 0.1 for a quick run).
+ * Build options such as -DFIFO_INDEX_TYPE=uint32_t, -DFIFO_FREE_RUNNING=1 or
+ * -DFIFO_CRITICAL_BACKEND=FIFO_CRITICAL_SPINLOCK or
+ * -DUART_MESSAGE_INTEGRITY=UART_INTEGRITY_CRC32C are recorded in the "config" object
+ * of the output; build once per critical-section backend to compare their cost.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "fifo_buffer.h"
+#include "fifo_buffer_inline.h"
+#include "uart_message_fifo.h"
+#include "fifo_spsc.h"
+#include "fifo_mpsc.h"
+#include "fifo_mpmc.h"
+#include "fifo_simd.h"
+#include "fifo_crc.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define BENCH_MAX_SIZE		4096	///< Largest FIFO_Buffer size measured
+#define BENCH_CHUNK			16		///< Operations timed together for one latency sample
+#define BENCH_SAMPLES		8192	///< Latency samples kept per measurement
+#define BENCH_FIFO_OPS		20000000ULL	///< Operations per FIFO_Buffer measurement
+#define BENCH_UART_BYTES	20000000ULL	///< Frame bytes moved per UART measurement
+#define BENCH_THREAD_OPS	2000000ULL	///< Elements moved per threaded queue measurement
+#define BENCH_MAX_THREADS	64			///< Most producer or consumer threads started
+
+_Static_assert((fifo_index_t)~(fifo_index_t)0 >= 16384,
+	"The benchmark uses buffers of up to 16384 bytes, build it with a 16-bit or wider FIFO_INDEX_TYPE");
+
+static double bench_scale = 1.0;		///< Iteration multiplier from the command line
+static bool bench_first_result = true;	///< No comma before the first result object
+static volatile uint8_t bench_sink;		///< Keeps popped and peeked values alive
+
+/**
+ * Latency samples of one measurement, in nanoseconds per operation.
+ */
+typedef struct {
+	double ns[BENCH_SAMPLES];
+	size_t count;
+} Bench_Samples;
+
+/**
+ * @brief Reads the monotonic clock.
+ *
+ * @return The current time in nanoseconds.
+ */
+static uint64_t Bench_Now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Scales a base iteration count by the command line factor.
+ *
+ * @param base Iteration count at scale 1.0.
+ * @param minimum Smallest count returned.
+ * @return The scaled count.
+ */
+static uint64_t Bench_Iterations(uint64_t base, uint64_t minimum) {
+	uint64_t scaled = (uint64_t)((double)base * bench_scale);
+	return (scaled < minimum) ? minimum : scaled;
+}
+
+/**
+ * @brief Records the average latency of a timed chunk of operations.
+ *
+ * @param samples Sample set to add to; full sets ignore further samples.
+ * @param elapsed_ns Duration of the chunk.
+ * @param ops Number of operations in the chunk.
+ */
+static void Bench_AddSample(Bench_Samples *samples, uint64_t elapsed_ns, uint32_t ops) {
+	if (samples->count < BENCH_SAMPLES && ops > 0) {
+		samples->ns[samples->count++] = (double)elapsed_ns / ops;
+	}
+}
+
+static int Bench_CompareDouble(const void *a, const void *b) {
+	double x = *(const double *)a;
+	double y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * @brief Prints one result object of the "results" array.
+ *
+ * @param group Benchmark group, e.g. "fifo" or "uart".
+ * @param name Operation measured.
+ * @param variant Parameters of the measurement, e.g. "size=64,call".
+ * @param unit What one operation moves: "byte", "frame" or "element".
+ * @param ops Number of operations performed.
+ * @param elapsed_ns Total time taken by the operations.
+ * @param samples Latency samples, or NULL if latency was not sampled. Sorted in place.
+ */
+static void Bench_Report(const char *group, const char *name, const char *variant, const char *unit,
+		uint64_t ops, uint64_t elapsed_ns, Bench_Samples *samples) {
+	double seconds = (double)elapsed_ns / 1e9;
+	printf("%s\n    {\"group\": \"%s\", \"name\": \"%s\", \"variant\": \"%s\", \"unit\": \"%s\", "
+		"\"ops\": %llu, \"seconds\": %.6f, \"ns_per_op\": %.3f, \"ops_per_sec\": %.0f",
+		bench_first_result ? "" : ",", group, name, variant, unit, (unsigned long long)ops, seconds,
+		ops ? (double)elapsed_ns / ops : 0.0, seconds > 0 ? (double)ops / seconds : 0.0);
+	bench_first_result = false;
+
+	if (samples != NULL && samples->count > 0) {
+		qsort(samples->ns, samples->count, sizeof(samples->ns[0]), Bench_CompareDouble);
+		printf(", \"latency_ns\": {\"min\": %.3f, \"p50\": %.3f, \"p99\": %.3f, \"max\": %.3f}",
+			samples->ns[0], samples->ns[samples->count / 2],
+			samples->ns[(samples->count * 99) / 100], samples->ns[samples->count - 1]);
+	}
+	printf("}");
+}
+
+/**
+ * Generates a function measuring the single-byte FIFO_Buffer operations through the
+ * given push, pop, peek and overwrite functions, so the out-of-line API and the
+ * *Inline variants are timed by identical loops.
+ *
+ * Throughput is timed once per fill or drain of the whole buffer. Latency is sampled in
+ * a second pass over chunks of BENCH_CHUNK operations, because the clock costs about as
+ * much as a single push; each sample still includes one clock read spread over the chunk.
+ */
+#define BENCH_DEFINE_FIFO_OPS(function, push, pop, peek, push_overwrite) \
+\
+static void function(const char *variant, fifo_index_t size) { \
+	static uint8_t storage[BENCH_MAX_SIZE]; \
+	static Bench_Samples push_samples, pop_samples, peek_samples, overwrite_samples; \
+	FIFO_Buffer fifo; \
+	uint8_t value = 0, sink = 0; \
+	uint64_t push_ns = 0, pop_ns = 0, peek_ns = 0, overwrite_ns = 0; \
+	uint64_t rounds = Bench_Iterations(BENCH_FIFO_OPS, size) / size; \
+	\
+	FIFO_Init(&fifo, storage, size); \
+	for (uint64_t round = 0; round < rounds; round++) { \
+		uint64_t start = Bench_Now(); \
+		for (fifo_index_t i = 0; i < size; i++) { \
+			push(&fifo, (uint8_t)i); \
+		} \
+		uint64_t pushed = Bench_Now(); \
+		for (fifo_index_t i = 0; i < size; i++) { \
+			peek(&fifo, i, &value); \
+			sink ^= value; \
+		} \
+		uint64_t peeked = Bench_Now(); \
+		for (fifo_index_t i = 0; i < size; i++) { \
+			push_overwrite(&fifo, (uint8_t)i); \
+		} \
+		uint64_t overwritten = Bench_Now(); \
+		for (fifo_index_t i = 0; i < size; i++) { \
+			pop(&fifo, &value); \
+			sink ^= value; \
+		} \
+		uint64_t popped = Bench_Now(); \
+		push_ns += pushed - start; \
+		peek_ns += peeked - pushed; \
+		overwrite_ns += overwritten - peeked; \
+		pop_ns += popped - overwritten; \
+	} \
+	\
+	push_samples.count = pop_samples.count = peek_samples.count = overwrite_samples.count = 0; \
+	while (push_samples.count < BENCH_SAMPLES) { \
+		for (fifo_index_t i = 0; i < size; i += BENCH_CHUNK) { \
+			fifo_index_t n = (size - i < BENCH_CHUNK) ? size - i : BENCH_CHUNK; \
+			uint64_t start = Bench_Now(); \
+			for (fifo_index_t j = 0; j < n; j++) { \
+				push(&fifo, (uint8_t)j); \
+			} \
+			Bench_AddSample(&push_samples, Bench_Now() - start, n); \
+		} \
+		for (fifo_index_t i = 0; i < size; i += BENCH_CHUNK) { \
+			fifo_index_t n = (size - i < BENCH_CHUNK) ? size - i : BENCH_CHUNK; \
+			uint64_t start = Bench_Now(); \
+			for (fifo_index_t j = 0; j < n; j++) { \
+				peek(&fifo, i + j, &value); \
+				sink ^= value; \
+			} \
+			Bench_AddSample(&peek_samples, Bench_Now() - start, n); \
+		} \
+		for (fifo_index_t i = 0; i < size; i += BENCH_CHUNK) { \
+			fifo_index_t n = (size - i < BENCH_CHUNK) ? size - i : BENCH_CHUNK; \
+			uint64_t start = Bench_Now(); \
+			for (fifo_index_t j = 0; j < n; j++) { \
+				push_overwrite(&fifo, (uint8_t)j); \
+			} \
+			Bench_AddSample(&overwrite_samples, Bench_Now() - start, n); \
+		} \
+		for (fifo_index_t i = 0; i < size; i += BENCH_CHUNK) { \
+			fifo_index_t n = (size - i < BENCH_CHUNK) ? size - i : BENCH_CHUNK; \
+			uint64_t start = Bench_Now(); \
+			for (fifo_index_t j = 0; j < n; j++) { \
+				pop(&fifo, &value); \
+				sink ^= value; \
+			} \
+			Bench_AddSample(&pop_samples, Bench_Now() - start, n); \
+		} \
+	} \
+	bench_sink = sink; \
+	\
+	uint64_t ops = rounds * size; \
+	Bench_Report("fifo", "push", variant, "byte", ops, push_ns, &push_samples); \
+	Bench_Report("fifo", "pop", variant, "byte", ops, pop_ns, &pop_samples); \
+	Bench_Report("fifo", "peek", variant, "byte", ops, peek_ns, &peek_samples); \
+	Bench_Report("fifo", "push_overwrite", variant, "byte", ops, overwrite_ns, &overwrite_samples); \
+}
+
+BENCH_DEFINE_FIFO_OPS(Bench_FifoCall, FIFO_Push, FIFO_Pop, FIFO_Peek, FIFO_PushOverwrite)
+BENCH_DEFINE_FIFO_OPS(Bench_FifoInline, FIFO_PushInline, FIFO_PopInline, FIFO_PeekInline, FIFO_PushOverwriteInline)
+
+/**
+ * @brief Measures the single-byte FIFO_Buffer operations for power-of-two and other sizes.
+ */
+static void Bench_FifoOps(void) {
+	static const fifo_index_t sizes[] = { 64, 96, 1024, 1000 };
+	char variant[64];
+
+	for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+		const char *wrap = ((sizes[i] & (sizes[i] - 1)) == 0) ? "pow2" : "general";
+		snprintf(variant, sizeof(variant), "size=%u,%s,call", (unsigned)sizes[i], wrap);
+		Bench_FifoCall(variant, sizes[i]);
+		snprintf(variant, sizeof(variant), "size=%u,%s,inline", (unsigned)sizes[i], wrap);
+		Bench_FifoInline(variant, sizes[i]);
+	}
+}
+
+/**
+ * @brief Measures FIFO_PushSafe()/FIFO_PopSafe() against the unguarded calls.
+ *
+ * Runs on one thread, so it shows the uncontended cost of the critical-section backend.
+ */
+static void Bench_CriticalSection(void) {
+	static uint8_t storage[64];
+	FIFO_Buffer fifo;
+	uint8_t value = 0, sink = 0;
+	uint64_t ops = Bench_Iterations(BENCH_FIFO_OPS, 1);
+	char variant[64];
+
+	FIFO_Init(&fifo, storage, sizeof(storage));
+	uint64_t start = Bench_Now();
+	for (uint64_t i = 0; i < ops; i++) {
+		FIFO_Push(&fifo, (uint8_t)i);
+		FIFO_Pop(&fifo, &value);
+		sink ^= value;
+	}
+	uint64_t plain = Bench_Now();
+	for (uint64_t i = 0; i < ops; i++) {
+		FIFO_PushSafe(&fifo, (uint8_t)i);
+		FIFO_PopSafe(&fifo, &value);
+		sink ^= value;
+	}
+	uint64_t safe = Bench_Now();
+	bench_sink = sink;
+
+	snprintf(variant, sizeof(variant), "backend=%s", FIFO_CRITICAL_NAME);
+	Bench_Report("critical", "push_pop", "unguarded", "byte", ops, plain - start, NULL);
+	Bench_Report("critical", "push_pop_safe", variant, "byte", ops, safe - plain, NULL);
+}
+
+/**
+ * @brief Builds a valid UART frame with the integrity check selected at build time.
+ *
+ * @param frame Destination array of at least `length` bytes.
+ * @param length Total frame length, at least UART_MESSAGE_MIN_LENGTH.
+ */
+static void Bench_BuildFrame(uint8_t *frame, uint8_t length) {
+	for (uint8_t i = 2; i < length; i++) {
+		frame[i] = (uint8_t)(i * 7);
+	}
+	Seal_UART_Message(frame, length);
+}
+
+/**
+ * @brief Measures Add_UART_Message(), Get_UART_Message() and Get_UART_MessageView() frames per second.
+ *
+ * Each round fills the buffer with frames and drains it by copying, then fills it again
+ * and drains it with views, timing each phase. Both drains read the frame's type byte.
+ */
+static void Bench_UartMessages(void) {
+	static const uint8_t message_sizes[] = { 4, 16, 64, 255 };
+	static const fifo_index_t buffer_sizes[] = { BUFFER_SIZE, 1024, 4096 };
+	static uint8_t storage[BENCH_MAX_SIZE];
+	uint8_t frame[256], message[256], length, types = 0;
+	UART_Message_View view;
+	UART_Message_Stats stats;
+	char variant[64];
+
+	for (size_t b = 0; b < sizeof(buffer_sizes) / sizeof(buffer_sizes[0]); b++) {
+		for (size_t m = 0; m < sizeof(message_sizes) / sizeof(message_sizes[0]); m++) {
+			if (message_sizes[m] > buffer_sizes[b] || message_sizes[m] < UART_MESSAGE_MIN_LENGTH) {
+				continue;
+			}
+			FIFO_Buffer fifo;
+			FIFO_Init(&fifo, storage, buffer_sizes[b]);
+			Reset_UART_Message_Stats(&stats);
+			Bench_BuildFrame(frame, message_sizes[m]);
+
+			uint64_t frames_per_round = buffer_sizes[b] / message_sizes[m];
+			uint64_t rounds = Bench_Iterations(BENCH_UART_BYTES, buffer_sizes[b]) / (frames_per_round * message_sizes[m]);
+			uint64_t add_ns = 0, get_ns = 0, view_ns = 0, added = 0, got = 0, viewed = 0;
+			for (uint64_t round = 0; round < rounds; round++) {
+				uint64_t start = Bench_Now();
+				while (Add_UART_Message(&fifo, frame, message_sizes[m])) {
+					added++;
+				}
+				uint64_t filled = Bench_Now();
+				while (Get_UART_Message(&fifo, message, &length, &stats)) {
+					types ^= message[2];
+					got++;
+				}
+				uint64_t drained = Bench_Now();
+				while (Add_UART_Message(&fifo, frame, message_sizes[m])) {
+					added++;
+				}
+				uint64_t refilled = Bench_Now();
+				while (Get_UART_MessageView(&fifo, &view, &stats)) {
+					types ^= view.type;
+					Release_UART_Message(&fifo, &view, &stats);
+					viewed++;
+				}
+				uint64_t viewed_all = Bench_Now();
+				add_ns += (filled - start) + (refilled - drained);
+				get_ns += drained - filled;
+				view_ns += viewed_all - refilled;
+			}
+			bench_sink = types;
+
+			snprintf(variant, sizeof(variant), "message=%u,buffer=%u", (unsigned)message_sizes[m], (unsigned)buffer_sizes[b]);
+			Bench_Report("uart", "add_message", variant, "frame", added, add_ns, NULL);
+			Bench_Report("uart", "get_message", variant, "frame", got, get_ns, NULL);
+			Bench_Report("uart", "get_message_view", variant, "frame", viewed, view_ns, NULL);
+		}
+	}
+}
+
+/**
+ * @brief Measures FIFO_FindByte() over a full, wrapped buffer with every SIMD level.
+ *
+ * The byte is absent, so each call scans both ring segments completely.
+ */
+static void Bench_FindByte(void) {
+	static const char *level_names[] = { "scalar", "sse2", "sse42", "avx2" };
+	static uint8_t storage[BENCH_MAX_SIZE];
+	FIFO_Buffer fifo;
+	fifo_index_t found = 0;
+	char variant[64];
+
+	FIFO_Init(&fifo, storage, BENCH_MAX_SIZE);
+	FIFO_WriteCommit(&fifo, BENCH_MAX_SIZE / 2);	// Move the tail to the middle so the data wraps
+	FIFO_ReadRelease(&fifo, BENCH_MAX_SIZE / 2);
+	for (fifo_index_t i = 0; i < BENCH_MAX_SIZE; i++) {
+		FIFO_Push(&fifo, (uint8_t)(i % MESSAGE_START_BYTE));	// Never equals the start byte
+	}
+
+	FIFO_SIMD_Level supported = FIFO_SIMD_SetLevel(FIFO_SIMD_AVX2);
+	for (int level = FIFO_SIMD_SCALAR; level <= (int)supported; level++) {
+		if (level == FIFO_SIMD_SSE42) {
+			continue;	// Same scan kernel as SSE2
+		}
+		FIFO_SIMD_SetLevel((FIFO_SIMD_Level)level);
+		uint64_t calls = Bench_Iterations(BENCH_FIFO_OPS * 10, BENCH_MAX_SIZE) / BENCH_MAX_SIZE;
+		uint64_t start = Bench_Now();
+		for (uint64_t i = 0; i < calls; i++) {
+			found += FIFO_FindByte(&fifo, 0, MESSAGE_START_BYTE);
+		}
+		uint64_t elapsed = Bench_Now() - start;
+		bench_sink = (uint8_t)found;
+
+		snprintf(variant, sizeof(variant), "size=%u,%s", (unsigned)BENCH_MAX_SIZE, level_names[level]);
+		Bench_Report("scan", "find_byte", variant, "byte", calls * BENCH_MAX_SIZE, elapsed, NULL);
+	}
+	FIFO_SIMD_SetLevel(FIFO_SIMD_AVX2);
+}
+
+/**
+ * @brief Byte-at-a-time XOR, the checksum loop Get_UART_Message() used before FIFO_SIMD_Xor().
+ */
+static uint8_t Bench_XorLoop(const uint8_t *data, size_t length) {
+	uint8_t checksum = 0;
+	for (size_t i = 0; i < length; i++) {
+		checksum ^= data[i];
+	}
+	return checksum;
+}
+
+/**
+ * @brief Measures the frame checksum: the byte loop against FIFO_SIMD_Xor() at every SIMD level.
+ *
+ * The checksum runs over FIFO_PeekSegments() of a wrapped buffer, as in the parser.
+ */
+static void Bench_Checksum(void) {
+	static const char *level_names[] = { "scalar", "sse2", "sse42", "avx2" };
+	static const fifo_index_t lengths[] = { 16, 64, 253, 4000 };
+	static uint8_t storage[BENCH_MAX_SIZE];
+	FIFO_Buffer fifo;
+	FIFO_Segments segments;
+	uint8_t checksum = 0;
+	char variant[64];
+
+	FIFO_Init(&fifo, storage, BENCH_MAX_SIZE);
+	FIFO_WriteCommit(&fifo, BENCH_MAX_SIZE / 2);	// Move the tail to the middle so the data wraps
+	FIFO_ReadRelease(&fifo, BENCH_MAX_SIZE / 2);
+	for (fifo_index_t i = 0; i < BENCH_MAX_SIZE; i++) {
+		FIFO_Push(&fifo, (uint8_t)(i * 31));
+	}
+
+	FIFO_SIMD_Level supported = FIFO_SIMD_SetLevel(FIFO_SIMD_AVX2);
+	for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+		fifo_index_t index = BENCH_MAX_SIZE / 2 - lengths[l] / 2;	// Straddles the wrap point
+		FIFO_PeekSegments(&fifo, index, lengths[l], &segments);
+		uint64_t calls = Bench_Iterations(BENCH_FIFO_OPS * 10, lengths[l]) / lengths[l];
+
+		uint64_t start = Bench_Now();
+		for (uint64_t i = 0; i < calls; i++) {
+			checksum ^= Bench_XorLoop(segments.data[0], segments.length[0]) ^
+				Bench_XorLoop(segments.data[1], segments.length[1]);
+		}
+		uint64_t elapsed = Bench_Now() - start;
+		snprintf(variant, sizeof(variant), "length=%u,byte_loop", (unsigned)lengths[l]);
+		Bench_Report("checksum", "xor", variant, "byte", calls * lengths[l], elapsed, NULL);
+
+		for (int level = FIFO_SIMD_SCALAR; level <= (int)supported; level++) {
+			if (level == FIFO_SIMD_SSE42) {
+				continue;	// Same XOR kernel as SSE2
+			}
+			FIFO_SIMD_SetLevel((FIFO_SIMD_Level)level);
+			start = Bench_Now();
+			for (uint64_t i = 0; i < calls; i++) {
+				checksum ^= FIFO_SIMD_Xor(segments.data[0], segments.length[0]) ^
+					FIFO_SIMD_Xor(segments.data[1], segments.length[1]);
+			}
+			elapsed = Bench_Now() - start;
+			snprintf(variant, sizeof(variant), "length=%u,%s", (unsigned)lengths[l], level_names[level]);
+			Bench_Report("checksum", "xor", variant, "byte", calls * lengths[l], elapsed, NULL);
+		}
+		FIFO_SIMD_SetLevel(FIFO_SIMD_AVX2);
+	}
+	bench_sink = checksum;
+}
+
+/**
+ * @brief Measures FIFO_CRC16_Update() and FIFO_CRC32C_Update() over a wrapped buffer.
+ *
+ * Both run over FIFO_PeekSegments(), as in the parser; CRC-32C is measured with the
+ * slicing tables and, when the CPU has it, the SSE4.2 crc32 instruction.
+ */
+static void Bench_Integrity(void) {
+	static const fifo_index_t lengths[] = { 16, 64, 253, 4000 };
+	static uint8_t storage[BENCH_MAX_SIZE];
+	FIFO_Buffer fifo;
+	FIFO_Segments segments;
+	uint32_t crc = 0;
+	char variant[64];
+
+	FIFO_Init(&fifo, storage, BENCH_MAX_SIZE);
+	FIFO_WriteCommit(&fifo, BENCH_MAX_SIZE / 2);	// Move the tail to the middle so the data wraps
+	FIFO_ReadRelease(&fifo, BENCH_MAX_SIZE / 2);
+	for (fifo_index_t i = 0; i < BENCH_MAX_SIZE; i++) {
+		FIFO_Push(&fifo, (uint8_t)(i * 31));
+	}
+
+	FIFO_SIMD_Level supported = FIFO_SIMD_SetLevel(FIFO_SIMD_AVX2);
+	for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+		fifo_index_t index = BENCH_MAX_SIZE / 2 - lengths[l] / 2;	// Straddles the wrap point
+		FIFO_PeekSegments(&fifo, index, lengths[l], &segments);
+		uint64_t calls = Bench_Iterations(BENCH_FIFO_OPS * 10, lengths[l]) / lengths[l];
+
+		uint64_t start = Bench_Now();
+		for (uint64_t i = 0; i < calls; i++) {
+			uint16_t crc16 = FIFO_CRC16_Update(FIFO_CRC16_INITIAL, segments.data[0], segments.length[0]);
+			crc ^= FIFO_CRC16_Update(crc16, segments.data[1], segments.length[1]);
+		}
+		uint64_t elapsed = Bench_Now() - start;
+		snprintf(variant, sizeof(variant), "length=%u,slices=%u", (unsigned)lengths[l], (unsigned)FIFO_CRC_SLICES);
+		Bench_Report("integrity", "crc16", variant, "byte", calls * lengths[l], elapsed, NULL);
+
+		for (int level = FIFO_SIMD_SCALAR; level <= (int)supported; level += FIFO_SIMD_SSE42) {
+			FIFO_SIMD_SetLevel((FIFO_SIMD_Level)level);	// Scalar uses the tables, SSE4.2 and up the instruction
+			start = Bench_Now();
+			for (uint64_t i = 0; i < calls; i++) {
+				uint32_t crc32c = FIFO_CRC32C_Update(FIFO_CRC32C_INITIAL, segments.data[0], segments.length[0]);
+				crc ^= FIFO_CRC32C_Final(FIFO_CRC32C_Update(crc32c, segments.data[1], segments.length[1]));
+			}
+			elapsed = Bench_Now() - start;
+			if (level == FIFO_SIMD_SCALAR) {
+				snprintf(variant, sizeof(variant), "length=%u,slices=%u", (unsigned)lengths[l], (unsigned)FIFO_CRC_SLICES);
+			} else {
+				snprintf(variant, sizeof(variant), "length=%u,sse42", (unsigned)lengths[l]);
+			}
+			Bench_Report("integrity", "crc32c", variant, "byte", calls * lengths[l], elapsed, NULL);
+		}
+		FIFO_SIMD_SetLevel(FIFO_SIMD_AVX2);
+	}
+	bench_sink = (uint8_t)crc;
+}
+
+/**
+ * @brief Measures how fast Get_UART_Message() skips line noise before a valid frame.
+ *
+ * Each round buffers `noise` bytes without a start byte followed by one 16-byte frame.
+ */
+static void Bench_UartResync(void) {
+	static const fifo_index_t noise_sizes[] = { 64, 1024, 4000 };
+	static uint8_t storage[BENCH_MAX_SIZE];
+	uint8_t frame[16], message[256], length = 0;
+	UART_Message_Stats stats;
+	char variant[64];
+
+	Bench_BuildFrame(frame, sizeof(frame));
+	for (size_t n = 0; n < sizeof(noise_sizes) / sizeof(noise_sizes[0]); n++) {
+		FIFO_Buffer fifo;
+		FIFO_Init(&fifo, storage, BENCH_MAX_SIZE);
+		Reset_UART_Message_Stats(&stats);
+		uint64_t rounds = Bench_Iterations(BENCH_UART_BYTES, noise_sizes[n]) / noise_sizes[n];
+		uint64_t elapsed = 0;
+		for (uint64_t round = 0; round < rounds; round++) {
+			fifo_index_t reserved = noise_sizes[n];
+			uint8_t *noise = FIFO_WriteReserve(&fifo, &reserved);
+			memset(noise, 0x55, reserved);
+			FIFO_WriteCommit(&fifo, reserved);
+			for (fifo_index_t i = reserved; i < noise_sizes[n]; i++) {
+				FIFO_Push(&fifo, 0x55);	// Rest of the noise after the wrap point
+			}
+			FIFO_PushBlock(&fifo, frame, sizeof(frame));
+
+			uint64_t start = Bench_Now();
+			Get_UART_Message(&fifo, message, &length, &stats);
+			elapsed += Bench_Now() - start;
+		}
+		bench_sink = length;
+
+		snprintf(variant, sizeof(variant), "noise=%u,buffer=%u", (unsigned)noise_sizes[n], (unsigned)BENCH_MAX_SIZE);
+		Bench_Report("uart", "resync", variant, "byte", rounds * noise_sizes[n], elapsed, NULL);
+	}
+}
+
+/**
+ * Work shared by the threads of one threaded queue measurement.
+ */
+typedef struct {
+	void *queue;					///< FIFO_SPSC_Buffer, FIFO_MPSC_Buffer or FIFO_MPMC_Queue
+	uint64_t ops;					///< Elements each producer pushes
+	atomic_ullong consumed;			///< Elements popped by all consumers so far
+	uint64_t total;					///< Elements pushed by all producers together
+} Bench_ThreadWork;
+
+static void *Bench_SpscProducer(void *arg) {
+	Bench_ThreadWork *work = arg;
+	for (uint64_t i = 0; i < work->ops; i++) {
+		while (!FIFO_SPSC_Push(work->queue, (uint8_t)i)) {
+			sched_yield();	// Let the consumer run, also on single-CPU hosts
+		}
+	}
+	FIFO_SPSC_FlushPush(work->queue);
+	return NULL;
+}
+
+/**
+ * @brief Measures SPSC throughput between two threads for several sizes and batch settings.
+ */
+static void Bench_Spsc(void) {
+	static const fifo_index_t sizes[] = { 64, 1024, 16384 };
+	static const fifo_index_t batches[] = { 1, 16 };
+	char variant[64];
+
+	for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+		for (size_t b = 0; b < sizeof(batches) / sizeof(batches[0]); b++) {
+			FIFO_SPSC_Buffer fifo;
+			if (!FIFO_SPSC_Init_Dynamic(&fifo, sizes[s]) || !FIFO_SPSC_SetBatch(&fifo, batches[b])) {
+				continue;
+			}
+			Bench_ThreadWork work = { .queue = &fifo, .ops = Bench_Iterations(BENCH_THREAD_OPS, 1) };
+			pthread_t producer;
+			uint8_t value, sink = 0;
+
+			uint64_t start = Bench_Now();
+			pthread_create(&producer, NULL, Bench_SpscProducer, &work);
+			for (uint64_t i = 0; i < work.ops; i++) {
+				while (!FIFO_SPSC_Pop(&fifo, &value)) {
+					sched_yield();
+				}
+				sink ^= value;
+			}
+			pthread_join(producer, NULL);
+			uint64_t elapsed = Bench_Now() - start;
+			bench_sink = sink;
+			FIFO_SPSC_Free(&fifo);
+
+			snprintf(variant, sizeof(variant), "size=%u,batch=%u", (unsigned)sizes[s], (unsigned)batches[b]);
+			Bench_Report("spsc", "push_pop", variant, "byte", work.ops, elapsed, NULL);
+		}
+	}
+}
+
+static void *Bench_MpscProducer(void *arg) {
+	Bench_ThreadWork *work = arg;
+	for (uint64_t i = 0; i < work->ops; i++) {
+		while (!FIFO_MPSC_Push(work->queue, (uint8_t)i)) {
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief Measures MPSC throughput with 1 to 16 producers and one consumer.
+ */
+static void Bench_Mpsc(void) {
+	static const unsigned producer_counts[] = { 1, 2, 4, 8, 16 };
+	char variant[64];
+
+	for (size_t p = 0; p < sizeof(producer_counts) / sizeof(producer_counts[0]); p++) {
+		unsigned producers = producer_counts[p];
+		FIFO_MPSC_Buffer fifo;
+		if (!FIFO_MPSC_Init_Dynamic(&fifo, 1024)) {
+			continue;
+		}
+		Bench_ThreadWork work = { .queue = &fifo, .ops = Bench_Iterations(BENCH_THREAD_OPS, producers) / producers };
+		pthread_t threads[BENCH_MAX_THREADS];
+		uint64_t total = work.ops * producers;
+		uint8_t value, sink = 0;
+
+		uint64_t start = Bench_Now();
+		for (unsigned t = 0; t < producers; t++) {
+			pthread_create(&threads[t], NULL, Bench_MpscProducer, &work);
+		}
+		for (uint64_t i = 0; i < total; i++) {
+			while (!FIFO_MPSC_Pop(&fifo, &value)) {
+				sched_yield();
+			}
+			sink ^= value;
+		}
+		for (unsigned t = 0; t < producers; t++) {
+			pthread_join(threads[t], NULL);
+		}
+		uint64_t elapsed = Bench_Now() - start;
+		bench_sink = sink;
+		FIFO_MPSC_Free(&fifo);
+
+		snprintf(variant, sizeof(variant), "size=1024,producers=%u", producers);
+		Bench_Report("mpsc", "push_pop", variant, "byte", total, elapsed, NULL);
+	}
+}
+
+static void *Bench_MpmcProducer(void *arg) {
+	Bench_ThreadWork *work = arg;
+	for (uint64_t i = 0; i < work->ops; i++) {
+		while (!FIFO_MPMC_Push(work->queue, &i)) {
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+static void *Bench_MpmcConsumer(void *arg) {
+	Bench_ThreadWork *work = arg;
+	uint64_t value, sink = 0;
+	while (atomic_load_explicit(&work->consumed, memory_order_relaxed) < work->total) {
+		if (FIFO_MPMC_Pop(work->queue, &value)) {
+			sink ^= value;
+			atomic_fetch_add_explicit(&work->consumed, 1, memory_order_relaxed);
+		} else {
+			sched_yield();
+		}
+	}
+	bench_sink = (uint8_t)sink;
+	return NULL;
+}
+
+/**
+ * @brief Measures MPMC throughput of 8-byte elements with equal producer and consumer counts.
+ *
+ * The thread count per side doubles from 1 up to the number of online CPUs, which is
+ * always measured as the last point of the curve.
+ */
+static void Bench_Mpmc(void) {
+	long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	unsigned max_threads = (cpus < 1) ? 1 : (cpus > BENCH_MAX_THREADS) ? BENCH_MAX_THREADS : (unsigned)cpus;
+	char variant[64];
+
+	for (unsigned threads = 1; threads <= max_threads;
+		threads = (threads < max_threads && threads * 2 > max_threads) ? max_threads : threads * 2) {
+		FIFO_MPMC_Queue queue;
+		if (!FIFO_MPMC_Init_Dynamic(&queue, 1024, sizeof(uint64_t))) {
+			continue;
+		}
+		Bench_ThreadWork work = { .queue = &queue, .ops = Bench_Iterations(BENCH_THREAD_OPS, threads) / threads };
+		work.total = work.ops * threads;
+		atomic_init(&work.consumed, 0);
+		pthread_t producers[BENCH_MAX_THREADS], consumers[BENCH_MAX_THREADS];
+
+		uint64_t start = Bench_Now();
+		for (unsigned t = 0; t < threads; t++) {
+			pthread_create(&producers[t], NULL, Bench_MpmcProducer, &work);
+			pthread_create(&consumers[t], NULL, Bench_MpmcConsumer, &work);
+		}
+		for (unsigned t = 0; t < threads; t++) {
+			pthread_join(producers[t], NULL);
+			pthread_join(consumers[t], NULL);
+		}
+		uint64_t elapsed = Bench_Now() - start;
+		FIFO_MPMC_Free(&queue);
+
+		snprintf(variant, sizeof(variant), "size=1024,element=8,producers=%u,consumers=%u", threads, threads);
+		Bench_Report("mpmc", "push_pop", variant, "element", work.total, elapsed, NULL);
+	}
+}
+
+int main(int argc, char **argv) {
+	if (argc > 1) {
+		bench_scale = atof(argv[1]);
+		if (bench_scale <= 0) {
+			fprintf(stderr, "usage: %s [scale]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	printf("{\n  \"config\": {\"cpus\": %ld, \"index_bits\": %u, \"free_running\": %d, \"stats\": %d, "
+		"\"critical\": \"%s\", \"integrity\": %d, \"scale\": %g},\n", sysconf(_SC_NPROCESSORS_ONLN),
+		(unsigned)(sizeof(fifo_index_t) * 8), FIFO_FREE_RUNNING, FIFO_STATS_ENABLED, FIFO_CRITICAL_NAME,
+		UART_MESSAGE_INTEGRITY, bench_scale);
+	printf("  \"results\": [");
+	Bench_FifoOps();
+	Bench_CriticalSection();
+	Bench_UartMessages();
+	Bench_UartResync();
+	Bench_FindByte();
+	Bench_Checksum();
+	Bench_Integrity();
+	Bench_Spsc();
+	Bench_Mpsc();
+	Bench_Mpmc();
+	printf("\n  ]\n}\n");
+	return 0;
+}
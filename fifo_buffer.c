@@ -5,8 +5,97 @@
  *  Author: yamil
  */ 
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE		// memfd_create() for the mirrored allocation mode
+#endif
+
 #include "fifo_buffer.h"
+#include "fifo_buffer_inline.h"
+#include "fifo_simd.h"
 #include <stdio.h>
+#include <string.h>
+
+#if FIFO_MIRROR_SUPPORTED
+#include <sys/mman.h>
+#endif
+#if FIFO_EVENTFD_SUPPORTED
+#include <sys/eventfd.h>
+#endif
+#if FIFO_MIRROR_SUPPORTED || FIFO_EVENTFD_SUPPORTED
+#include <unistd.h>
+#endif
+
+/**
+ * Argument for the FIFO_Critical* functions: the per-FIFO lock, if the backend uses one.
+ */
+#if FIFO_CRITICAL_HAS_LOCK
+#define FIFO_LOCK(fifo)		(&(fifo)->lock)
+#else
+#define FIFO_LOCK(fifo)		NULL
+#endif
+
+/**
+ * @brief Records the buffer size and selects the wraparound mode for it.
+ * 
+ * Power-of-two sizes wrap with a mask instead of the `%` operator, which avoids an
+ * integer division on every push and pop.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param size Size of the buffer.
+ */
+static void FIFO_SetSize(FIFO_Buffer *fifo, fifo_index_t size) {
+	fifo->size = size;
+	fifo->mask = size - 1;
+	fifo->power_of_two = (size != 0) && ((size & (size - 1)) == 0);
+}
+
+/**
+ * @brief Checks whether the head and tail counters can represent a buffer of this size.
+ * 
+ * With FIFO_FREE_RUNNING, counters of sizes that are not a power of two run modulo
+ * 2 * size, which must fit in the index type.
+ * 
+ * @param size Size of the buffer.
+ * @return true if the size is usable, false otherwise.
+ */
+static bool FIFO_SizeSupported(fifo_index_t size) {
+#if FIFO_FREE_RUNNING
+	if ((size & (size - 1)) != 0 && size > (fifo_index_t)((fifo_index_t)~(fifo_index_t)0 >> 1)) {
+		return false;
+	}
+#endif
+	return size != 0;
+}
+
+/**
+ * @brief Marks a FIFO buffer as owning nothing, so FIFO_Deinit() and FIFO_Free() skip it.
+ * 
+ * Called first by the init functions that can fail, so a structure left with stack
+ * garbage by a failed init is still safe to release.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ */
+static void FIFO_ClearOwnership(FIFO_Buffer *fifo) {
+	fifo->buffer = NULL;
+	fifo->mirrored = false;
+#if FIFO_EVENTFD_SUPPORTED
+	fifo->event_fd = -1;
+#endif
+}
+
+/**
+ * @brief Returns how many bytes can be accessed contiguously starting at a position.
+ * 
+ * For a mirrored buffer the array is mapped twice back to back, so any run of up to
+ * `size` bytes is contiguous; otherwise the run stops at the end of the array.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param position Position in the range [0, size).
+ * @return The number of bytes addressable from `&buffer[position]` without wrapping.
+ */
+static inline fifo_index_t FIFO_Contiguous(const FIFO_Buffer *fifo, fifo_index_t position) {
+	return fifo->mirrored ? fifo->size : fifo->size - position;
+}
 
 /**
  * @brief Initializes a statically allocated FIFO buffer.
@@ -16,17 +105,53 @@
  * 
  * @param fifo Pointer to the FIFO buffer structure to initialize.
  * @param buffer Pointer to a statically allocated array to be used as the buffer.
- * @param size Size of the statically allocated buffer.
+ * @param size Size of the statically allocated buffer. With FIFO_FREE_RUNNING, sizes that
+ *             are not a power of two must not exceed half the index range.
  */
-void FIFO_Init(FIFO_Buffer *fifo, uint8_t *buffer, uint16_t size) {
+void FIFO_Init(FIFO_Buffer *fifo, uint8_t *buffer, fifo_index_t size) {
     fifo->buffer = buffer;						// Assign the statically allocated array
-    fifo->size = size;							// Set the buffer size
+    FIFO_SetSize(fifo, size);					// Set the buffer size and wraparound mode
     fifo->head = 0;								// Initialize head pointer
     fifo->tail = 0;								// Initialize tail pointer
+#if !FIFO_FREE_RUNNING
     fifo->count = 0;							// Initialize the count of elements
+#endif
     fifo->high_watermark = size - (size / 4);	// Default high watermark (75% full)
     fifo->low_watermark = size / 4;				// Default low watermark (25% full)
     fifo->overwrite_enabled = false;			// Default: no overwrite
+    fifo->mirrored = false;						// Plain array, wraps at the end
+    fifo->raise_trigger = size;					// Watermark triggers disarmed
+    fifo->lower_trigger = 0;
+    fifo->watermark_callback = NULL;			// No watermark callback
+    fifo->watermark_context = NULL;
+    fifo->watermark_state = FIFO_WATERMARK_LOW;	// Empty, so the first crossing is the high watermark
+#if FIFO_STATS_ENABLED
+    memset(&fifo->stats, 0, sizeof(fifo->stats));	// Clear the operation counters
+#endif
+    FIFO_CriticalInit(FIFO_LOCK(fifo));			// Lock used by the *Safe functions
+#if FIFO_EVENTFD_SUPPORTED
+    fifo->event_fd = -1;						// No eventfd attached
+#endif
+}
+
+/**
+ * @brief Initializes a statically allocated FIFO buffer whose size is a power of two.
+ * 
+ * Same as FIFO_Init(), but rejects sizes that are not a power of two so the caller is
+ * guaranteed the mask-based wraparound in the push/pop hot path.
+ * 
+ * @param fifo Pointer to the FIFO buffer structure to initialize.
+ * @param buffer Pointer to a statically allocated array to be used as the buffer.
+ * @param size Size of the statically allocated buffer, must be a power of two.
+ * @return true if initialization was successful, false if the size is not a power of two.
+ */
+bool FIFO_Init_Pow2(FIFO_Buffer *fifo, uint8_t *buffer, fifo_index_t size) {
+	FIFO_ClearOwnership(fifo);
+	if (size == 0 || (size & (size - 1)) != 0) {
+		return false; // Size is not a power of two
+	}
+	FIFO_Init(fifo, buffer, size);
+	return true;
 }
 
 /**
@@ -36,29 +161,137 @@ void FIFO_Init(FIFO_Buffer *fifo, uint8_t *buffer, uint16_t size) {
  * @param size Size of the buffer.
  * @return true if initialization was successful, false otherwise.
  */
-bool FIFO_Init_Dynamic(FIFO_Buffer *fifo, uint16_t size) {
+bool FIFO_Init_Dynamic(FIFO_Buffer *fifo, fifo_index_t size) {
+	FIFO_ClearOwnership(fifo);	// A failed init leaves nothing for FIFO_Free() to release
+	if (!FIFO_SizeSupported(size)) {
+		return false; // Counters cannot represent this size
+	}
 	fifo->buffer = (uint8_t *)malloc(size * sizeof(uint8_t));
 	if (fifo->buffer == NULL) {
 		return false; // Memory allocation failed
 	}
-	fifo->size = size;
+	FIFO_SetSize(fifo, size);
 	fifo->head = 0;
 	fifo->tail = 0;
+#if !FIFO_FREE_RUNNING
 	fifo->count = 0;
+#endif
 	fifo->high_watermark = size - 1;	// Default to near full
 	fifo->low_watermark = 1;			// Default to near empty
 	fifo->overwrite_enabled = false;    // Default: no overwrite
+	fifo->mirrored = false;
+	fifo->raise_trigger = size;
+	fifo->lower_trigger = 0;
+	fifo->watermark_callback = NULL;
+	fifo->watermark_context = NULL;
+	fifo->watermark_state = FIFO_WATERMARK_LOW;
+#if FIFO_STATS_ENABLED
+	memset(&fifo->stats, 0, sizeof(fifo->stats));
+#endif
+	FIFO_CriticalInit(FIFO_LOCK(fifo));
+#if FIFO_EVENTFD_SUPPORTED
+	fifo->event_fd = -1;
+#endif
+	return true;
+}
+
+#if FIFO_MIRROR_SUPPORTED
+/**
+ * @brief Initializes a FIFO buffer whose memory is mapped twice back to back.
+ * 
+ * The same memfd pages are mapped at `buffer` and at `buffer + size`, so the `count`
+ * bytes starting at the tail are always one contiguous slice, even across the wrap
+ * point. Block copies, FIFO_ReadClaim() and FIFO_WriteReserve() then never split a
+ * span in two. Free the buffer with FIFO_Free() as usual.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param size Size of the buffer, must be a non-zero multiple of the page size.
+ * @return true if initialization was successful, false otherwise.
+ */
+bool FIFO_Init_Mirrored(FIFO_Buffer *fifo, fifo_index_t size) {
+	FIFO_ClearOwnership(fifo);	// A failed init leaves nothing for FIFO_Free() to release
+	long page_size = sysconf(_SC_PAGESIZE);
+	if (!FIFO_SizeSupported(size) || page_size <= 0 || (size_t)size % (size_t)page_size != 0) {
+		return false; // Mappings must cover whole pages
+	}
+	
+	int fd = memfd_create("fifo_buffer", MFD_CLOEXEC);
+	if (fd < 0) {
+		return false;
+	}
+	if (ftruncate(fd, (off_t)size) != 0) {
+		close(fd);
+		return false;
+	}
+	
+	// Reserve the whole window first so both halves land next to each other
+	uint8_t *base = mmap(NULL, 2 * (size_t)size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (base == MAP_FAILED) {
+		close(fd);
+		return false;
+	}
+	if (mmap(base, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+		mmap(base + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+		munmap(base, 2 * (size_t)size);
+		close(fd);
+		return false;
+	}
+	close(fd);	// The mappings keep the memory alive
+	
+	FIFO_Init(fifo, base, size);
+	fifo->mirrored = true;
 	return true;
 }
+#endif
+
+/**
+ * @brief Releases the resources of a FIFO buffer without freeing its memory.
+ * 
+ * Closes the eventfd opened with FIFO_OpenEventFd(), if any, and releases the lock of
+ * the critical-section backend. Call it when a buffer set up with FIFO_Init() or
+ * FIFO_Init_Pow2() is no longer used; buffers from FIFO_Init_Dynamic() or
+ * FIFO_Init_Mirrored() are released with FIFO_Free(), which calls it.
+ * 
+ * Afterwards the buffer pointer is NULL, so calling it again, or after a failed init,
+ * does nothing.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ */
+void FIFO_Deinit(FIFO_Buffer *fifo) {
+	if (fifo->buffer == NULL) {
+		return; // Never initialized, or already released
+	}
+#if FIFO_EVENTFD_SUPPORTED
+	FIFO_CloseEventFd(fifo);
+#endif
+	FIFO_CriticalDestroy(FIFO_LOCK(fifo));
+	FIFO_ClearOwnership(fifo);
+}
 
 /**
  * @brief Frees the dynamically allocated buffer memory.
  * 
+ * Also releases the eventfd and the lock, see FIFO_Deinit(). Does nothing if the
+ * buffer was already freed or its init failed.
+ * 
  * @param fifo Pointer to the FIFO buffer.
  */
 void FIFO_Free(FIFO_Buffer *fifo) {
-	free(fifo->buffer);
-	fifo->buffer = NULL;
+	uint8_t *buffer = fifo->buffer;
+	if (buffer == NULL) {
+		return; // Never initialized, or already freed
+	}
+	bool mirrored = fifo->mirrored;
+	FIFO_Deinit(fifo);
+#if FIFO_MIRROR_SUPPORTED
+	if (mirrored) {
+		munmap(buffer, 2 * (size_t)fifo->size);
+		return;
+	}
+#else
+	(void)mirrored;
+#endif
+	free(buffer);
 }
 
 /**
@@ -69,7 +302,10 @@ void FIFO_Free(FIFO_Buffer *fifo) {
 void FIFO_Reset(FIFO_Buffer *fifo) {
 	fifo->head = 0;
 	fifo->tail = 0;
+#if !FIFO_FREE_RUNNING
 	fifo->count = 0;
+#endif
+	FIFO_LevelLowered(fifo, 0);
 }
 
 /**
@@ -80,20 +316,7 @@ void FIFO_Reset(FIFO_Buffer *fifo) {
  * @return true if successful, false if the buffer is full.
  */
 bool FIFO_Push(FIFO_Buffer *fifo, uint8_t data) {
-	if (fifo->count == fifo->size) {
-		if (fifo->overwrite_enabled) {
-			// Overwrite: Advance the tail pointer to discard the oldest byte
-			fifo->tail = (fifo->tail + 1) % fifo->size;
-		} else {
-			return false; // Buffer is full, and overwriting is disabled
-		}
-	} else {
-		fifo->count++;
-	}
-
-	fifo->buffer[fifo->head] = data;			// Insert the new data
-	fifo->head = (fifo->head + 1) % fifo->size; // Advance the head pointer
-	return true;
+	return FIFO_PushInline(fifo, data);
 }
 
 /**
@@ -103,13 +326,7 @@ bool FIFO_Push(FIFO_Buffer *fifo, uint8_t data) {
  * @param data The byte to push into the buffer.
  */
 void FIFO_PushOverwrite(FIFO_Buffer *fifo, uint8_t data) {
-	if (fifo->count == fifo->size) {
-		fifo->tail = (fifo->tail + 1) % fifo->size; // Overwrite oldest data
-	} else {
-		fifo->count++;
-	}
-	fifo->buffer[fifo->head] = data;
-	fifo->head = (fifo->head + 1) % fifo->size;
+	FIFO_PushOverwriteInline(fifo, data);
 }
 
 /**
@@ -120,13 +337,7 @@ void FIFO_PushOverwrite(FIFO_Buffer *fifo, uint8_t data) {
  * @return true if successful, false if the buffer is empty.
  */
 bool FIFO_Pop(FIFO_Buffer *fifo, uint8_t *data) {
-	if (fifo->count == 0) {
-		return false; // Buffer is empty
-	}
-	*data = fifo->buffer[fifo->tail];
-	fifo->tail = (fifo->tail + 1) % fifo->size;
-	fifo->count--;
-	return true;
+	return FIFO_PopInline(fifo, data);
 }
 
 /**
@@ -137,15 +348,352 @@ bool FIFO_Pop(FIFO_Buffer *fifo, uint8_t *data) {
  * @param data Pointer to store the peeked byte.
  * @return true if successful, false if the index is out of bounds.
  */
-bool FIFO_Peek(FIFO_Buffer *fifo, uint16_t index, uint8_t *data) {
-	if (index >= fifo->count) {
-		return false; // Index out of bounds
+bool FIFO_Peek(FIFO_Buffer *fifo, fifo_index_t index, uint8_t *data) {
+	return FIFO_PeekInline(fifo, index, data);
+}
+
+/**
+ * @brief Copies bytes out of the FIFO buffer without consuming them.
+ * 
+ * The copy starts `offset` bytes after the tail and is done in at most two memcpy() calls:
+ * one up to the end of the underlying array and one from its start. The caller must make
+ * sure that `offset + length` does not exceed the current count.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param offset Offset from the oldest byte at which to start copying.
+ * @param data Destination array.
+ * @param length Number of bytes to copy.
+ */
+static void FIFO_CopyOut(FIFO_Buffer *fifo, fifo_index_t offset, uint8_t *data, fifo_index_t length) {
+	fifo_index_t start = FIFO_Offset(fifo, FIFO_TailIndex(fifo), offset);
+	fifo_index_t first = FIFO_Contiguous(fifo, start);	// Bytes available before the wrap point
+	if (first > length) {
+		first = length;
 	}
-	uint16_t position = (fifo->tail + index) % fifo->size;
-	*data = fifo->buffer[position];
+	memcpy(data, &fifo->buffer[start], first);
+	memcpy(&data[first], fifo->buffer, length - first);
+}
+
+/**
+ * @brief Advances the tail pointer by a number of bytes, discarding them.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param length Number of bytes to discard, must not exceed the current count.
+ */
+static void FIFO_Discard(FIFO_Buffer *fifo, fifo_index_t length) {
+	FIFO_AdvanceTail(fifo, length);
+}
+
+/**
+ * @brief Pushes a block of bytes into the FIFO buffer.
+ * 
+ * The bytes are copied in at most two memcpy() calls around the wrap point, so a whole
+ * span costs one bounds check instead of one per byte. If the buffer lacks space and
+ * overwrite mode is disabled, only as many bytes as fit are pushed. With overwrite mode
+ * enabled the oldest bytes are discarded to make room, and if `length` exceeds the
+ * buffer size only the last `size` bytes of `data` are kept.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param data Pointer to the bytes to push.
+ * @param length Number of bytes to push.
+ * @return The number of bytes taken from `data`.
+ */
+fifo_index_t FIFO_PushBlock(FIFO_Buffer *fifo, const uint8_t *data, fifo_index_t length) {
+	fifo_index_t accepted = length;
+	fifo_index_t space = fifo->size - FIFO_CountInline(fifo);
+	
+	if (length > space) {
+		if (fifo->overwrite_enabled) {
+			if (length > fifo->size) {
+				data += length - fifo->size;	// Older bytes would be overwritten anyway
+				length = fifo->size;
+			}
+			FIFO_Discard(fifo, length - space);	// Make room by dropping the oldest bytes
+			FIFO_STAT_ADD(fifo, overwrites, length - space);
+		} else {
+			FIFO_STAT_ADD(fifo, rejects, length - space);
+			length = space;
+			accepted = space;
+		}
+	}
+	
+	fifo_index_t head = FIFO_HeadIndex(fifo);
+	fifo_index_t first = FIFO_Contiguous(fifo, head);	// Bytes that fit before the wrap point
+	if (first > length) {
+		first = length;
+	}
+	memcpy(&fifo->buffer[head], data, first);
+	memcpy(fifo->buffer, &data[first], length - first);
+	FIFO_AdvanceHead(fifo, length);
+	FIFO_STAT_ADD(fifo, pushes, length);
+	FIFO_STAT_PEAK(fifo, FIFO_CountInline(fifo));
+	FIFO_LevelRaised(fifo, FIFO_CountInline(fifo));
+	return accepted;
+}
+
+/**
+ * @brief Pops a block of bytes from the FIFO buffer.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param data Pointer to an array to store the popped bytes.
+ * @param length Maximum number of bytes to pop.
+ * @return The number of bytes popped, which is less than `length` if the buffer held fewer bytes.
+ */
+fifo_index_t FIFO_PopBlock(FIFO_Buffer *fifo, uint8_t *data, fifo_index_t length) {
+	fifo_index_t count = FIFO_CountInline(fifo);
+	if (count == 0) {
+		FIFO_STAT_ADD(fifo, empty_pops, 1);
+	}
+	if (length > count) {
+		length = count;
+	}
+	FIFO_CopyOut(fifo, 0, data, length);
+	FIFO_Discard(fifo, length);
+	FIFO_STAT_ADD(fifo, pops, length);
+	FIFO_LevelLowered(fifo, count - length);
+	return length;
+}
+
+/**
+ * @brief Copies a block of bytes from the FIFO buffer without removing them.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param index Index of the first byte to copy (0 for the oldest byte).
+ * @param data Pointer to an array to store the copied bytes.
+ * @param length Maximum number of bytes to copy.
+ * @return The number of bytes copied, which is less than `length` if fewer bytes follow `index`.
+ */
+fifo_index_t FIFO_PeekBlock(FIFO_Buffer *fifo, fifo_index_t index, uint8_t *data, fifo_index_t length) {
+	fifo_index_t count = FIFO_CountInline(fifo);
+	if (index >= count) {
+		return 0;
+	}
+	if (length > count - index) {
+		length = count - index;
+	}
+	FIFO_CopyOut(fifo, index, data, length);
+	return length;
+}
+
+/**
+ * @brief Describes stored bytes in place, without copying or consuming them.
+ * 
+ * The range is returned as one segment, or two when it crosses the wrap point, so
+ * checksums and parsers can run directly over the ring. The pointers stay valid until
+ * the bytes are popped or overwritten.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param index Index of the first byte (0 for the oldest byte).
+ * @param length Maximum number of bytes to describe.
+ * @param segments Receives the segments.
+ * @return The number of bytes described, which is less than `length` if fewer bytes follow `index`.
+ */
+fifo_index_t FIFO_PeekSegments(FIFO_Buffer *fifo, fifo_index_t index, fifo_index_t length, FIFO_Segments *segments) {
+	fifo_index_t count = FIFO_CountInline(fifo);
+	if (index >= count) {
+		length = 0;
+		index = 0;
+	} else if (length > count - index) {
+		length = count - index;
+	}
+	
+	fifo_index_t start = FIFO_Offset(fifo, FIFO_TailIndex(fifo), index);
+	fifo_index_t first = FIFO_Contiguous(fifo, start);	// Bytes before the wrap point
+	if (first > length) {
+		first = length;
+	}
+	segments->data[0] = &fifo->buffer[start];
+	segments->length[0] = first;
+	segments->data[1] = fifo->buffer;
+	segments->length[1] = length - first;
+	return length;
+}
+
+/**
+ * @brief Finds the next occurrence of a byte without consuming anything.
+ * 
+ * The stored bytes are searched in place, in at most two contiguous segments around
+ * the wrap point, with the SSE2/AVX2 kernels of fifo_simd.c where available.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param index Index to start searching at (0 for the oldest byte).
+ * @param value Byte to look for.
+ * @return Index of the first matching byte at or after `index`, or the current count if there is none.
+ */
+fifo_index_t FIFO_FindByte(FIFO_Buffer *fifo, fifo_index_t index, uint8_t value) {
+	fifo_index_t count = FIFO_CountInline(fifo);
+	if (index >= count) {
+		return count;
+	}
+	
+	fifo_index_t start = FIFO_Offset(fifo, FIFO_TailIndex(fifo), index);
+	fifo_index_t first = FIFO_Contiguous(fifo, start);	// Bytes before the wrap point
+	if (first > count - index) {
+		first = count - index;
+	}
+	fifo_index_t found = (fifo_index_t)FIFO_SIMD_FindByte(&fifo->buffer[start], first, value);
+	if (found < first) {
+		return index + found;
+	}
+	found = (fifo_index_t)FIFO_SIMD_FindByte(fifo->buffer, count - index - first, value);
+	return index + first + found;	// Equals count when the byte was not found
+}
+
+/**
+ * @brief Checks whether the stored bytes at an index match a pattern.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param index Index of the first byte to compare, `index + length` must not exceed the count.
+ * @param pattern Bytes to compare with.
+ * @param length Number of bytes to compare.
+ * @return true if all bytes match.
+ */
+static bool FIFO_Matches(FIFO_Buffer *fifo, fifo_index_t index, const uint8_t *pattern, fifo_index_t length) {
+	fifo_index_t start = FIFO_Offset(fifo, FIFO_TailIndex(fifo), index);
+	fifo_index_t first = FIFO_Contiguous(fifo, start);
+	if (first > length) {
+		first = length;
+	}
+	return memcmp(&fifo->buffer[start], pattern, first) == 0 &&
+		memcmp(fifo->buffer, &pattern[first], length - first) == 0;
+}
+
+/**
+ * @brief Finds the next occurrence of a multi-byte pattern, e.g. a frame delimiter.
+ * 
+ * Candidates are located with FIFO_FindByte() on the first pattern byte and then
+ * compared in place, so a pattern that straddles the wrap point is found as well. A
+ * pattern that is only partially buffered yet is not reported; when resynchronizing,
+ * keep the last `length - 1` bytes so it can still complete.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param index Index to start searching at (0 for the oldest byte).
+ * @param pattern Bytes to look for.
+ * @param length Number of bytes in the pattern, at least 1.
+ * @return Index of the first byte of the first match at or after `index`, or the current count if there is none.
+ */
+fifo_index_t FIFO_FindPattern(FIFO_Buffer *fifo, fifo_index_t index, const uint8_t *pattern, fifo_index_t length) {
+	fifo_index_t count = FIFO_CountInline(fifo);
+	if (length == 0 || length > count) {
+		return count;
+	}
+	
+	fifo_index_t last = count - length;	// Last index at which a whole match fits
+	while (index <= last) {
+		index = FIFO_FindByte(fifo, index, pattern[0]);
+		if (index > last) {
+			break;
+		}
+		if (FIFO_Matches(fifo, index, pattern, length)) {
+			return index;
+		}
+		index++;
+	}
+	return count;
+}
+
+/**
+ * @brief Reserves a contiguous writable span at the head of the FIFO buffer.
+ * 
+ * The span lies directly inside the ring, so a driver can DMA or read() into it and then
+ * publish the bytes with FIFO_WriteCommit() without an intermediate copy. The span never
+ * crosses the wrap point (unless the buffer is mirrored), so it can be shorter than
+ * requested even when the buffer has more free space; reserve again after committing
+ * to get the rest. Reserving does not
+ * change the buffer and never overwrites data, regardless of overwrite mode.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param length On input, the number of bytes wanted. On output, the number of bytes available in the span.
+ * @return Pointer to the start of the span, or NULL if no space is available.
+ */
+uint8_t *FIFO_WriteReserve(FIFO_Buffer *fifo, fifo_index_t *length) {
+	fifo_index_t head = FIFO_HeadIndex(fifo);
+	fifo_index_t available = fifo->size - FIFO_CountInline(fifo);
+	fifo_index_t to_end = FIFO_Contiguous(fifo, head);
+	if (available > to_end) {
+		available = to_end;	// Stop at the wrap point
+	}
+	if (*length > available) {
+		*length = available;
+	}
+	return (*length > 0) ? &fifo->buffer[head] : NULL;
+}
+
+/**
+ * @brief Publishes bytes written into a span obtained from FIFO_WriteReserve().
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param length Number of bytes written, at most the length granted by the reservation.
+ * @return true if successful, false if `length` exceeds the free space before the wrap point.
+ */
+bool FIFO_WriteCommit(FIFO_Buffer *fifo, fifo_index_t length) {
+	fifo_index_t count = FIFO_CountInline(fifo);
+	if (length > fifo->size - count || length > FIFO_Contiguous(fifo, FIFO_HeadIndex(fifo))) {
+		return false; // More than could have been reserved
+	}
+	FIFO_AdvanceHead(fifo, length);
+	FIFO_STAT_ADD(fifo, pushes, length);
+	FIFO_STAT_PEAK(fifo, count + length);
+	FIFO_LevelRaised(fifo, count + length);
 	return true;
 }
 
+/**
+ * @brief Claims a contiguous readable span at the tail of the FIFO buffer.
+ * 
+ * The span points into the ring, so a parser can inspect the bytes in place and then
+ * consume them with FIFO_ReadRelease(). Like FIFO_WriteReserve(), the span stops at the
+ * wrap point unless the buffer is mirrored; claim again after releasing to reach the
+ * bytes that follow it.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param length On input, the number of bytes wanted. On output, the number of bytes available in the span.
+ * @return Pointer to the oldest byte, or NULL if the buffer is empty.
+ */
+const uint8_t *FIFO_ReadClaim(FIFO_Buffer *fifo, fifo_index_t *length) {
+	fifo_index_t tail = FIFO_TailIndex(fifo);
+	fifo_index_t available = FIFO_CountInline(fifo);
+	fifo_index_t to_end = FIFO_Contiguous(fifo, tail);
+	if (available > to_end) {
+		available = to_end;	// Stop at the wrap point
+	}
+	if (*length > available) {
+		*length = available;
+	}
+	return (*length > 0) ? &fifo->buffer[tail] : NULL;
+}
+
+/**
+ * @brief Consumes bytes from the tail of the FIFO buffer without copying them.
+ * 
+ * Usually called after FIFO_ReadClaim(), but any number of bytes up to the current
+ * count may be released, including bytes on both sides of the wrap point.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param length Number of bytes to consume.
+ * @return true if successful, false if `length` exceeds the current count.
+ */
+bool FIFO_ReadRelease(FIFO_Buffer *fifo, fifo_index_t length) {
+	fifo_index_t count = FIFO_CountInline(fifo);
+	if (length > count) {
+		return false; // Cannot release more than is stored
+	}
+	FIFO_Discard(fifo, length);
+	FIFO_STAT_ADD(fifo, pops, length);
+	FIFO_LevelLowered(fifo, count - length);
+	return true;
+}
+
+/**
+ * @brief Returns the number of bytes in the FIFO buffer.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @return The number of bytes currently stored.
+ */
+fifo_index_t FIFO_Count(FIFO_Buffer *fifo) {
+	return FIFO_CountInline(fifo);
+}
+
 /**
  * @brief Checks if the FIFO buffer is empty.
  * 
@@ -153,7 +701,7 @@ bool FIFO_Peek(FIFO_Buffer *fifo, uint16_t index, uint8_t *data) {
  * @return true if empty, false otherwise.
  */
 bool FIFO_IsEmpty(FIFO_Buffer *fifo) {
-	return fifo->count == 0;
+	return FIFO_CountInline(fifo) == 0;
 }
 
 /**
@@ -163,7 +711,7 @@ bool FIFO_IsEmpty(FIFO_Buffer *fifo) {
  * @return true if full, false otherwise.
  */
 bool FIFO_IsFull(FIFO_Buffer *fifo) {
-	return fifo->count == fifo->size;
+	return FIFO_CountInline(fifo) == fifo->size;
 }
 
 /**
@@ -173,89 +721,281 @@ bool FIFO_IsFull(FIFO_Buffer *fifo) {
  */
 void FIFO_DebugPrint(FIFO_Buffer *fifo) {
 	printf("FIFO Debug Info:\n");
-	printf("Size: %u, Count: %u, Head: %u, Tail: %u\n", fifo->size, fifo->count, fifo->head, fifo->tail);
-	for (uint16_t i = 0; i < fifo->count; i++) {
+	printf("Size: %lu, Count: %lu, Head: %lu, Tail: %lu\n", (unsigned long)fifo->size,
+		(unsigned long)FIFO_Count(fifo), (unsigned long)fifo->head, (unsigned long)fifo->tail);
+	for (fifo_index_t i = 0; i < FIFO_Count(fifo); i++) {
 		uint8_t data;
 		FIFO_Peek(fifo, i, &data);
-		printf("Index %u: %02X\n", i, data);
+		printf("Index %lu: %02X\n", (unsigned long)i, data);
 	}
 }
 
-/**
- * @brief Safely pushes a byte into the FIFO buffer by disabling interrupts during the operation.
- * 
- * This function ensures that no interrupt can interfere while pushing data into the FIFO buffer,
- * making it safe to use in an interrupt-driven or multi-threaded environment.
- * 
- * @param fifo Pointer to the FIFO buffer.
- * @param data The byte to push into the buffer.
- * @return true if the operation is successful, false if the buffer is full.
+/**
+ * @brief Safely pushes a byte into the FIFO buffer inside a critical section.
+ * 
+ * This function ensures that no interrupt or other thread can interfere while pushing data
+ * into the FIFO buffer, making it safe to use in an interrupt-driven or multi-threaded
+ * environment. The critical section comes from the backend selected in fifo_critical.h:
+ * interrupt masking on AVR, a mutex or a spinlock on hosts.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param data The byte to push into the buffer.
+ * @return true if the operation is successful, false if the buffer is full.
  */
 bool FIFO_PushSafe(FIFO_Buffer *fifo, uint8_t data) {
-	uint8_t sreg = SREG; // Save the global interrupt flag
-	cli(); // Disable interrupts
+	fifo_critical_state_t state = FIFO_CriticalEnter(FIFO_LOCK(fifo));
 	bool result = FIFO_Push(fifo, data);
-	SREG = sreg; // Restore the interrupt flag
+	FIFO_CriticalExit(FIFO_LOCK(fifo), state);
 	return result;
 }
 
-/**
- * @brief Safely pops a byte from the FIFO buffer by disabling interrupts during the operation.
- * 
- * This function ensures that no interrupt can interfere while popping data from the FIFO buffer,
- * making it safe to use in an interrupt-driven or multi-threaded environment.
- * 
- * @param fifo Pointer to the FIFO buffer.
- * @param data Pointer to a variable where the popped byte will be stored.
- * @return true if the operation is successful, false if the buffer is empty.
+/**
+ * @brief Safely pops a byte from the FIFO buffer inside a critical section.
+ * 
+ * This function ensures that no interrupt or other thread can interfere while popping data
+ * from the FIFO buffer, making it safe to use in an interrupt-driven or multi-threaded
+ * environment. See FIFO_PushSafe() for the available backends.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param data Pointer to a variable where the popped byte will be stored.
+ * @return true if the operation is successful, false if the buffer is empty.
  */
 bool FIFO_PopSafe(FIFO_Buffer *fifo, uint8_t *data) {
-	uint8_t sreg = SREG; // Save the global interrupt flag
-	cli(); // Disable interrupts
+	fifo_critical_state_t state = FIFO_CriticalEnter(FIFO_LOCK(fifo));
 	bool result = FIFO_Pop(fifo, data);
-	SREG = sreg; // Restore the interrupt flag
+	FIFO_CriticalExit(FIFO_LOCK(fifo), state);
 	return result;
 }
 
-/**
- * @brief Enables or disables the overwrite mode for the FIFO buffer.
- * 
- * When overwrite mode is enabled, the FIFO buffer will discard the oldest data 
- * (by advancing the tail pointer) to make room for new data if the buffer is full. 
- * When overwrite mode is disabled, the buffer will reject new data if it is full.
- * 
- * This setting allows flexibility in handling data loss in scenarios where 
- * the latest data may be prioritized over the oldest data.
- * 
- * @param fifo Pointer to the FIFO buffer.
- * @param enable Pass `true` to enable overwrite mode, or `false` to disable it.
+/**
+ * @brief Enables or disables the overwrite mode for the FIFO buffer.
+ * 
+ * When overwrite mode is enabled, the FIFO buffer will discard the oldest data 
+ * (by advancing the tail pointer) to make room for new data if the buffer is full. 
+ * When overwrite mode is disabled, the buffer will reject new data if it is full.
+ * 
+ * This setting allows flexibility in handling data loss in scenarios where 
+ * the latest data may be prioritized over the oldest data.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param enable Pass `true` to enable overwrite mode, or `false` to disable it.
  */
 void FIFO_SetOverwrite(FIFO_Buffer *fifo, bool enable) {
 	fifo->overwrite_enabled = enable;
 }
 
-/**
- * @brief Checks the current fill level of the FIFO buffer against its watermarks.
- * 
- * This function compares the current number of bytes in the FIFO buffer (`count`)
- * with the configured high and low watermark thresholds. It can be used to monitor 
- * buffer usage and trigger events or notifications based on these thresholds.
- * 
- * - If the count exceeds or equals the high watermark, a high watermark event can be triggered.
- * - If the count falls below or equals the low watermark, a low watermark event can be triggered.
- * 
- * Note: This function does not perform the actual event handling; it only provides 
- * a mechanism to detect when the buffer usage crosses watermark thresholds.
- * 
- * @param fifo Pointer to the FIFO buffer.
- */
-void FIFO_CheckWatermarks(FIFO_Buffer *fifo) {
-	if (fifo->count >= fifo->high_watermark) {
-		// Trigger high watermark event
-	} else if (fifo->count <= fifo->low_watermark) {
-		// Trigger low watermark event
+/**
+ * @brief Classifies a fill level against the watermarks.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param count Number of bytes stored.
+ * @return FIFO_WATERMARK_LOW at or below the low watermark, FIFO_WATERMARK_HIGH at or
+ *         above the high watermark, FIFO_WATERMARK_NONE in between.
+ */
+static FIFO_WatermarkLevel FIFO_WatermarkOf(const FIFO_Buffer *fifo, fifo_index_t count) {
+	if (count <= fifo->low_watermark) {
+		return FIFO_WATERMARK_LOW;
+	}
+	return (count >= fifo->high_watermark) ? FIFO_WATERMARK_HIGH : FIFO_WATERMARK_NONE;
+}
+
+/**
+ * @brief Sets the push and pop triggers to the bounds of the range holding `count`.
+ * 
+ * The ranges are empty, low (up to the low watermark), normal and high (from the high
+ * watermark). FIFO_LevelRaised() and FIFO_LevelLowered() call FIFO_LevelCrossed() only
+ * when an operation leaves the current range. With nothing attached to the FIFO both
+ * triggers are disarmed and never fire.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param count Number of bytes stored.
+ */
+static void FIFO_ArmTriggers(FIFO_Buffer *fifo, fifo_index_t count) {
+	bool attached = fifo->watermark_callback != NULL;
+#if FIFO_EVENTFD_SUPPORTED
+	attached = attached || fifo->event_fd >= 0;
+#endif
+	if (!attached) {
+		fifo->raise_trigger = fifo->size;
+		fifo->lower_trigger = 0;
+	} else if (count == 0) {
+		fifo->raise_trigger = 0;
+		fifo->lower_trigger = 0;
+	} else if (count <= fifo->low_watermark) {
+		fifo->raise_trigger = fifo->low_watermark;
+		fifo->lower_trigger = 1;
+	} else if (count < fifo->high_watermark) {
+		fifo->raise_trigger = fifo->high_watermark - 1;
+		fifo->lower_trigger = fifo->low_watermark + 1;
+	} else {
+		fifo->raise_trigger = fifo->size;
+		fifo->lower_trigger = (fifo->high_watermark > fifo->low_watermark) ? fifo->high_watermark : fifo->low_watermark + 1;
+	}
+}
+
+/**
+ * @brief Calls the watermark callback if `count` crosses the watermark opposite to the last one reported.
+ * 
+ * Reporting alternates between high and low, so a level hovering around one watermark
+ * produces a single event until it reaches the other one.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param count Number of bytes stored.
+ */
+static void FIFO_ReportWatermark(FIFO_Buffer *fifo, fifo_index_t count) {
+	FIFO_WatermarkLevel level = FIFO_WatermarkOf(fifo, count);
+	if (level == FIFO_WATERMARK_NONE || level == fifo->watermark_state) {
+		return;
+	}
+	fifo->watermark_state = level;
+	if (fifo->watermark_callback != NULL) {
+		fifo->watermark_callback(fifo, level, fifo->watermark_context);
+	}
+}
+
+/**
+ * @brief Handles a push or pop that moved the fill level into another range.
+ * 
+ * Called through FIFO_LevelRaised() and FIFO_LevelLowered(). Signals the attached
+ * eventfd, reports a watermark crossing to the callback and re-arms the triggers.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param count Number of bytes stored after the operation.
+ */
+void FIFO_LevelCrossed(FIFO_Buffer *fifo, fifo_index_t count) {
+#if FIFO_EVENTFD_SUPPORTED
+	if (fifo->event_fd >= 0) {
+		uint64_t one = 1;
+		// A full counter (EAGAIN) still leaves the descriptor readable, so the error is ignored
+		ssize_t written = write(fifo->event_fd, &one, sizeof(one));
+		(void)written;
+	}
+#endif
+	FIFO_ReportWatermark(fifo, count);
+	FIFO_ArmTriggers(fifo, FIFO_CountInline(fifo));	// The callback may have changed the level
+}
+
+/**
+ * @brief Sets the watermark thresholds.
+ * 
+ * Use this instead of writing `high_watermark` and `low_watermark` directly, so the
+ * push/pop triggers follow the new thresholds.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param low Low watermark, should be below `high`.
+ * @param high High watermark.
+ */
+void FIFO_SetWatermarks(FIFO_Buffer *fifo, fifo_index_t low, fifo_index_t high) {
+	fifo->low_watermark = low;
+	fifo->high_watermark = high;
+	FIFO_ArmTriggers(fifo, FIFO_CountInline(fifo));
+}
+
+/**
+ * @brief Registers a function called when the fill level crosses a watermark.
+ * 
+ * The callback is invoked with FIFO_WATERMARK_HIGH when a push brings the count up to
+ * the high watermark, and with FIFO_WATERMARK_LOW when a pop brings it down to the low
+ * watermark. Events alternate: after a high event the next one is low and vice versa,
+ * which gives hysteresis between the two thresholds for flow control. The callback
+ * runs inside the push or pop that crossed the watermark, so keep it short.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param callback Function to call, or NULL to remove it.
+ * @param context Argument passed to the callback.
+ */
+void FIFO_SetWatermarkCallback(FIFO_Buffer *fifo, FIFO_WatermarkCallback callback, void *context) {
+	fifo_index_t count = FIFO_CountInline(fifo);
+	fifo->watermark_callback = callback;
+	fifo->watermark_context = context;
+	fifo->watermark_state = (count >= fifo->high_watermark) ? FIFO_WATERMARK_HIGH : FIFO_WATERMARK_LOW;
+	FIFO_ArmTriggers(fifo, count);
+}
+
+/**
+ * @brief Checks the current fill level of the FIFO buffer against its watermarks.
+ * 
+ * This function compares the current number of bytes in the FIFO buffer (`count`)
+ * with the configured high and low watermark thresholds. Push and pop already report
+ * crossings to the watermark callback, so calling this is only needed to catch up
+ * after the watermark fields were written directly: a pending crossing is reported
+ * and the triggers are re-armed.
+ * 
+ * - If the count exceeds or equals the high watermark, a high watermark event is triggered.
+ * - If the count falls below or equals the low watermark, a low watermark event is triggered.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @return The level of the current count relative to the watermarks.
+ */
+FIFO_WatermarkLevel FIFO_CheckWatermarks(FIFO_Buffer *fifo) {
+	fifo_index_t count = FIFO_Count(fifo);
+	FIFO_ReportWatermark(fifo, count);
+	FIFO_ArmTriggers(fifo, FIFO_CountInline(fifo));
+	return FIFO_WatermarkOf(fifo, count);
+}
+
+#if FIFO_STATS_ENABLED
+/**
+ * @brief Copies the operation counters of the FIFO buffer.
+ * 
+ * The copy is a plain structure copy; if the FIFO is used from an interrupt, take the
+ * snapshot with interrupts disabled to get counters that match each other.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param stats Pointer to the structure receiving the counters.
+ */
+void FIFO_GetStats(const FIFO_Buffer *fifo, FIFO_Stats *stats) {
+	*stats = fifo->stats;
+}
+
+/**
+ * @brief Clears the operation counters of the FIFO buffer.
+ * 
+ * The peak count restarts from the current fill level.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ */
+void FIFO_ResetStats(FIFO_Buffer *fifo) {
+	memset(&fifo->stats, 0, sizeof(fifo->stats));
+	fifo->stats.peak_count = FIFO_CountInline(fifo);
+}
+#endif
+
+#if FIFO_EVENTFD_SUPPORTED
+/**
+ * @brief Creates an eventfd and attaches it to the FIFO buffer.
+ * 
+ * The eventfd becomes readable whenever a push or pop moves the fill level into another
+ * range: empty to non-empty and back, and across the low or high watermark in either
+ * direction. It is edge-triggered in spirit: after it polls readable, read() it to clear
+ * it and then inspect the buffer with FIFO_Count(). The descriptor is non-blocking and
+ * close-on-exec, and is owned by the FIFO; close it with FIFO_CloseEventFd(), FIFO_Deinit() or FIFO_Free().
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @return The eventfd to register with poll()/epoll, or -1 if it could not be created.
+ */
+int FIFO_OpenEventFd(FIFO_Buffer *fifo) {
+	if (fifo->event_fd >= 0) {
+		return fifo->event_fd; // Already attached
+	}
+	fifo->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	FIFO_ArmTriggers(fifo, FIFO_CountInline(fifo));
+	return fifo->event_fd;
+}
+
+/**
+ * @brief Detaches and closes the eventfd opened with FIFO_OpenEventFd().
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ */
+void FIFO_CloseEventFd(FIFO_Buffer *fifo) {
+	if (fifo->event_fd >= 0) {
+		close(fifo->event_fd);
+		fifo->event_fd = -1;
+		FIFO_ArmTriggers(fifo, FIFO_CountInline(fifo));
 	}
 }
+#endif
 
 
 
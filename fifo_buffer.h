@@ -12,33 +12,172 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
-#include <atmel_start.h>
+#include "fifo_critical.h"
 
+/**
+ * Integer type used for the buffer size, the head and tail positions, the count and
+ * the watermarks. It bounds the largest buffer that can be created. Define
+ * FIFO_INDEX_TYPE (e.g. -DFIFO_INDEX_TYPE=uint32_t) to uint8_t, uint16_t, uint32_t or
+ * size_t to trade structure size for capacity; the default keeps the small 16-bit layout.
+ */
+#ifndef FIFO_INDEX_TYPE
+#define FIFO_INDEX_TYPE uint16_t
+#endif
+
+typedef FIFO_INDEX_TYPE fifo_index_t;
+
+/**
+ * Define FIFO_FREE_RUNNING to 1 to drop the `count` field. Head and tail then become
+ * free-running counters and the occupancy is `head - tail`, so a push only writes the
+ * head and a pop only writes the tail instead of both writing `count`. Counters of
+ * power-of-two buffers wrap with the index type; other sizes run modulo 2 * size and
+ * must not exceed half the index range. Use FIFO_Count() instead of reading `count`.
+ */
+#ifndef FIFO_FREE_RUNNING
+#define FIFO_FREE_RUNNING 0
+#endif
+
+/**
+ * FIFO_Init_Mirrored() maps the buffer twice in virtual memory and needs memfd_create()
+ * and mmap(), so it is only available on Linux.
+ */
+#if defined(__linux__)
+#define FIFO_MIRROR_SUPPORTED 1
+#else
+#define FIFO_MIRROR_SUPPORTED 0
+#endif
+
+/**
+ * Define FIFO_STATS_ENABLED to 1 to count pushes, pops, overwrites, rejected pushes,
+ * pops from an empty buffer and the peak fill level of every FIFO_Buffer. The counters
+ * and the code that updates them compile away entirely when it is 0.
+ */
+#ifndef FIFO_STATS_ENABLED
+#define FIFO_STATS_ENABLED 0
+#endif
+
+/**
+ * FIFO_OpenEventFd() attaches an eventfd that is signalled whenever the fill level moves
+ * between empty, low (at or below low_watermark), normal and high (at or above
+ * high_watermark), so an epoll loop can wait on many buffers at once. Needs eventfd(),
+ * so it is only available on Linux.
+ */
+#if defined(__linux__)
+#define FIFO_EVENTFD_SUPPORTED 1
+#else
+#define FIFO_EVENTFD_SUPPORTED 0
+#endif
+
+/**
+ * Fill level reported by FIFO_CheckWatermarks() and passed to the watermark callback.
+ */
+typedef enum {
+	FIFO_WATERMARK_NONE = 0,	///< Count is between the low and high watermarks
+	FIFO_WATERMARK_HIGH,		///< Count is at or above the high watermark
+	FIFO_WATERMARK_LOW			///< Count is at or below the low watermark
+} FIFO_WatermarkLevel;
+
+/**
+ * Stored bytes described in place as at most two contiguous segments, see FIFO_PeekSegments().
+ */
+typedef struct {
+	const uint8_t *data[2];			///< Start of each segment, the second one begins at the array start
+	fifo_index_t length[2];			///< Bytes in each segment, length[1] is 0 if the range does not wrap
+} FIFO_Segments;
+
+#if FIFO_STATS_ENABLED
+/**
+ * Operation counters of a FIFO_Buffer, see FIFO_GetStats(). All counts are in bytes.
+ */
 typedef struct {
-    uint8_t *buffer;			///< Pointer to the circular buffer
-    uint16_t size;				///< Total size of the buffer
-    uint16_t head;				///< Write pointer
-    uint16_t tail;				///< Read pointer
-    uint16_t count;				///< Current number of elements in the buffer
-    uint16_t high_watermark;	///< High watermark threshold
-    uint16_t low_watermark;		///< Low watermark threshold
-	bool overwrite_enabled;		///< Enable overwrite when buffer is full
+	uint32_t pushes;				///< Bytes stored by push, block push and write commit
+	uint32_t pops;					///< Bytes removed by pop, block pop and read release
+	uint32_t overwrites;			///< Old bytes discarded to make room in overwrite mode
+	uint32_t rejects;				///< Bytes refused because the buffer was full
+	uint32_t empty_pops;			///< Pop attempts on an empty buffer
+	fifo_index_t peak_count;		///< Highest number of bytes stored at once
+} FIFO_Stats;
+#endif
+
+struct FIFO_Buffer;
+
+/**
+ * Called from the push or pop that crossed a watermark, see FIFO_SetWatermarkCallback().
+ */
+typedef void (*FIFO_WatermarkCallback)(struct FIFO_Buffer *fifo, FIFO_WatermarkLevel level, void *context);
+
+typedef struct FIFO_Buffer {
+    uint8_t *buffer;				///< Pointer to the circular buffer
+    fifo_index_t size;				///< Total size of the buffer
+    fifo_index_t mask;				///< size - 1, used for wraparound when power_of_two is set
+    fifo_index_t head;				///< Write pointer (free-running counter if FIFO_FREE_RUNNING)
+    fifo_index_t tail;				///< Read pointer (free-running counter if FIFO_FREE_RUNNING)
+#if !FIFO_FREE_RUNNING
+    fifo_index_t count;				///< Current number of elements in the buffer
+#endif
+    fifo_index_t high_watermark;	///< High watermark threshold
+    fifo_index_t low_watermark;		///< Low watermark threshold
+    fifo_index_t raise_trigger;		///< A push that leaves more bytes than this re-evaluates the level
+    fifo_index_t lower_trigger;		///< A pop that leaves fewer bytes than this re-evaluates the level
+	FIFO_WatermarkCallback watermark_callback;	///< Called on watermark crossings, or NULL
+	void *watermark_context;		///< Argument passed to watermark_callback
+	FIFO_WatermarkLevel watermark_state;	///< Last watermark reported, for hysteresis
+	bool overwrite_enabled;			///< Enable overwrite when buffer is full
+	bool power_of_two;				///< Size is a power of two, wrap with mask instead of modulo
+	bool mirrored;					///< Memory is mapped twice, any span up to size is contiguous
+#if FIFO_CRITICAL_HAS_LOCK
+	fifo_critical_lock_t lock;		///< Lock taken by FIFO_PushSafe() and FIFO_PopSafe()
+#endif
+#if FIFO_STATS_ENABLED
+	FIFO_Stats stats;				///< Operation counters
+#endif
+#if FIFO_EVENTFD_SUPPORTED
+	int event_fd;					///< eventfd signalled on level changes, -1 if none is attached
+#endif
 } FIFO_Buffer;
 
 
-bool FIFO_Init_Dynamic(FIFO_Buffer *fifo, uint16_t size);
+void FIFO_Init(FIFO_Buffer *fifo, uint8_t *buffer, fifo_index_t size);
+bool FIFO_Init_Pow2(FIFO_Buffer *fifo, uint8_t *buffer, fifo_index_t size);
+bool FIFO_Init_Dynamic(FIFO_Buffer *fifo, fifo_index_t size);
+#if FIFO_MIRROR_SUPPORTED
+bool FIFO_Init_Mirrored(FIFO_Buffer *fifo, fifo_index_t size);
+#endif
+void FIFO_Deinit(FIFO_Buffer *fifo);
 void FIFO_Free(FIFO_Buffer *fifo);
 void FIFO_Reset(FIFO_Buffer *fifo);
 bool FIFO_Push(FIFO_Buffer *fifo, uint8_t data);
 void FIFO_PushOverwrite(FIFO_Buffer *fifo, uint8_t data);
 bool FIFO_Pop(FIFO_Buffer *fifo, uint8_t *data);
-bool FIFO_Peek(FIFO_Buffer *fifo, uint16_t index, uint8_t *data);
+bool FIFO_Peek(FIFO_Buffer *fifo, fifo_index_t index, uint8_t *data);
+fifo_index_t FIFO_PushBlock(FIFO_Buffer *fifo, const uint8_t *data, fifo_index_t length);
+fifo_index_t FIFO_PopBlock(FIFO_Buffer *fifo, uint8_t *data, fifo_index_t length);
+fifo_index_t FIFO_PeekBlock(FIFO_Buffer *fifo, fifo_index_t index, uint8_t *data, fifo_index_t length);
+fifo_index_t FIFO_PeekSegments(FIFO_Buffer *fifo, fifo_index_t index, fifo_index_t length, FIFO_Segments *segments);
+fifo_index_t FIFO_FindByte(FIFO_Buffer *fifo, fifo_index_t index, uint8_t value);
+fifo_index_t FIFO_FindPattern(FIFO_Buffer *fifo, fifo_index_t index, const uint8_t *pattern, fifo_index_t length);
+uint8_t *FIFO_WriteReserve(FIFO_Buffer *fifo, fifo_index_t *length);
+bool FIFO_WriteCommit(FIFO_Buffer *fifo, fifo_index_t length);
+const uint8_t *FIFO_ReadClaim(FIFO_Buffer *fifo, fifo_index_t *length);
+bool FIFO_ReadRelease(FIFO_Buffer *fifo, fifo_index_t length);
+fifo_index_t FIFO_Count(FIFO_Buffer *fifo);
 bool FIFO_IsEmpty(FIFO_Buffer *fifo);
 bool FIFO_IsFull(FIFO_Buffer *fifo);
 void FIFO_DebugPrint(FIFO_Buffer *fifo);
 bool FIFO_PushSafe(FIFO_Buffer *fifo, uint8_t data);
 bool FIFO_PopSafe(FIFO_Buffer *fifo, uint8_t *data);
 void FIFO_SetOverwrite(FIFO_Buffer *fifo, bool enable);
-void FIFO_CheckWatermarks(FIFO_Buffer *fifo);
+void FIFO_SetWatermarks(FIFO_Buffer *fifo, fifo_index_t low, fifo_index_t high);
+void FIFO_SetWatermarkCallback(FIFO_Buffer *fifo, FIFO_WatermarkCallback callback, void *context);
+FIFO_WatermarkLevel FIFO_CheckWatermarks(FIFO_Buffer *fifo);
+void FIFO_LevelCrossed(FIFO_Buffer *fifo, fifo_index_t count);
+#if FIFO_STATS_ENABLED
+void FIFO_GetStats(const FIFO_Buffer *fifo, FIFO_Stats *stats);
+void FIFO_ResetStats(FIFO_Buffer *fifo);
+#endif
+#if FIFO_EVENTFD_SUPPORTED
+int FIFO_OpenEventFd(FIFO_Buffer *fifo);
+void FIFO_CloseEventFd(FIFO_Buffer *fifo);
+#endif
 
 #endif /* FIFO_BUFFER_H_ */
\ No newline at end of file
@@ -0,0 +1,320 @@
+#ifndef FIFO_BUFFER_INLINE_H_
+#define FIFO_BUFFER_INLINE_H_
+
+#include "fifo_buffer.h"
+
+/*
+ * Header-only versions of the FIFO_Buffer hot path.
+ * 
+ * FIFO_Push(), FIFO_Pop() and friends in fifo_buffer.c are thin wrappers around these
+ * functions. Include this header and call the *Inline variants directly to let the
+ * compiler inline them into an ISR or a tight parser loop, where the call overhead and
+ * the repeated `fifo->` loads of an out-of-line call dominate a byte-sized operation.
+ * Both forms operate on the same FIFO_Buffer and can be mixed freely.
+ */
+
+/*
+ * Statistics hooks. With FIFO_STATS_ENABLED set to 0 they expand to nothing, so the
+ * push/pop paths are the same as without statistics support.
+ */
+#if FIFO_STATS_ENABLED
+#define FIFO_STAT_ADD(fifo, counter, amount)	((fifo)->stats.counter += (amount))
+#define FIFO_STAT_PEAK(fifo, level) \
+	do { \
+		if ((level) > (fifo)->stats.peak_count) { \
+			(fifo)->stats.peak_count = (level); \
+		} \
+	} while (0)
+#else
+#define FIFO_STAT_ADD(fifo, counter, amount)	((void)0)
+#define FIFO_STAT_PEAK(fifo, level)				((void)0)
+#endif
+
+/**
+ * @brief Computes the position that lies a number of bytes after another position.
+ * 
+ * Because `position` is below `size` and `offset` never exceeds `size`, the result needs
+ * at most one subtraction of `size`, which also keeps the sum from overflowing the index type.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param position Starting position, in the range [0, size).
+ * @param offset Number of bytes to move forward, at most `size`.
+ * @return The resulting position, in the range [0, size).
+ */
+static inline fifo_index_t FIFO_Offset(const FIFO_Buffer *fifo, fifo_index_t position, fifo_index_t offset) {
+	if (fifo->power_of_two) {
+		return (fifo_index_t)(position + offset) & fifo->mask;
+	}
+	fifo_index_t to_end = fifo->size - position;
+	return (offset < to_end) ? position + offset : offset - to_end;
+}
+
+#if FIFO_FREE_RUNNING
+
+/**
+ * @brief Returns the number of bytes in the FIFO buffer.
+ * 
+ * Head and tail are free-running counters, so the occupancy is their difference. For
+ * power-of-two sizes the counters wrap with the index type; for other sizes they run
+ * modulo 2 * size and a negative difference is corrected by adding 2 * size.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @return The number of bytes currently stored.
+ */
+static inline fifo_index_t FIFO_CountInline(const FIFO_Buffer *fifo) {
+	fifo_index_t count = (fifo_index_t)(fifo->head - fifo->tail);
+	if (!fifo->power_of_two && fifo->head < fifo->tail) {
+		count = (fifo_index_t)(count + 2 * fifo->size);
+	}
+	return count;
+}
+
+/**
+ * @brief Maps a free-running head or tail counter to a position in the array.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param counter Head or tail counter.
+ * @return The position in the range [0, size).
+ */
+static inline fifo_index_t FIFO_Position(const FIFO_Buffer *fifo, fifo_index_t counter) {
+	if (fifo->power_of_two) {
+		return counter & fifo->mask;
+	}
+	return (counter < fifo->size) ? counter : counter - fifo->size;
+}
+
+/**
+ * @brief Advances a free-running head or tail counter.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param counter Head or tail counter.
+ * @param length Number of bytes to advance by, at most `size`.
+ * @return The advanced counter.
+ */
+static inline fifo_index_t FIFO_Advance(const FIFO_Buffer *fifo, fifo_index_t counter, fifo_index_t length) {
+	if (fifo->power_of_two) {
+		return (fifo_index_t)(counter + length);
+	}
+	fifo_index_t to_end = 2 * fifo->size - counter;
+	return (length < to_end) ? counter + length : length - to_end;
+}
+
+#else
+
+/**
+ * @brief Returns the number of bytes in the FIFO buffer.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @return The number of bytes currently stored.
+ */
+static inline fifo_index_t FIFO_CountInline(const FIFO_Buffer *fifo) {
+	return fifo->count;
+}
+
+/**
+ * @brief Maps a head or tail value to a position in the array.
+ * 
+ * Without free-running counters head and tail already are positions.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param counter Head or tail value.
+ * @return The position in the range [0, size).
+ */
+static inline fifo_index_t FIFO_Position(const FIFO_Buffer *fifo, fifo_index_t counter) {
+	(void)fifo;
+	return counter;
+}
+
+/**
+ * @brief Advances a head or tail position, wrapping at the end of the buffer.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param counter Head or tail position.
+ * @param length Number of bytes to advance by, at most `size`.
+ * @return The advanced position.
+ */
+static inline fifo_index_t FIFO_Advance(const FIFO_Buffer *fifo, fifo_index_t counter, fifo_index_t length) {
+	return FIFO_Offset(fifo, counter, length);
+}
+
+#endif
+
+/**
+ * @brief Returns the array position the next pushed byte is written to.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @return The head position in the range [0, size).
+ */
+static inline fifo_index_t FIFO_HeadIndex(const FIFO_Buffer *fifo) {
+	return FIFO_Position(fifo, fifo->head);
+}
+
+/**
+ * @brief Returns the array position of the oldest byte.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @return The tail position in the range [0, size).
+ */
+static inline fifo_index_t FIFO_TailIndex(const FIFO_Buffer *fifo) {
+	return FIFO_Position(fifo, fifo->tail);
+}
+
+/**
+ * @brief Publishes bytes written at the head.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param length Number of bytes added, at most the free space.
+ */
+static inline void FIFO_AdvanceHead(FIFO_Buffer *fifo, fifo_index_t length) {
+	fifo->head = FIFO_Advance(fifo, fifo->head, length);
+#if !FIFO_FREE_RUNNING
+	fifo->count += length;
+#endif
+}
+
+/**
+ * @brief Consumes bytes at the tail.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param length Number of bytes removed, at most the current count.
+ */
+static inline void FIFO_AdvanceTail(FIFO_Buffer *fifo, fifo_index_t length) {
+	fifo->tail = FIFO_Advance(fifo, fifo->tail, length);
+#if !FIFO_FREE_RUNNING
+	fifo->count -= length;
+#endif
+}
+
+/**
+ * @brief Checks whether a push moved the fill level out of its current range.
+ * 
+ * This is the only watermark work on the push path: one compare against a trigger that
+ * FIFO_LevelCrossed() re-arms, and that is disarmed (set to size) while no callback or
+ * eventfd is attached.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param count Number of bytes stored after the push.
+ */
+static inline void FIFO_LevelRaised(FIFO_Buffer *fifo, fifo_index_t count) {
+	if (count > fifo->raise_trigger) {
+		FIFO_LevelCrossed(fifo, count);
+	}
+}
+
+/**
+ * @brief Checks whether a pop moved the fill level out of its current range.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param count Number of bytes stored after the pop.
+ */
+static inline void FIFO_LevelLowered(FIFO_Buffer *fifo, fifo_index_t count) {
+	if (count < fifo->lower_trigger) {
+		FIFO_LevelCrossed(fifo, count);
+	}
+}
+
+/**
+ * @brief Inline version of FIFO_Push().
+ * 
+ * The indices are updated and the watermark trigger is loaded before the byte is
+ * stored: a store through `uint8_t *` may alias the FIFO structure, so touching the
+ * fields afterwards would force the compiler to reload them. The trigger check after
+ * the store therefore compares against the local copy, like FIFO_LevelRaised().
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param data The byte to push into the buffer.
+ * @return true if successful, false if the buffer is full.
+ */
+static inline bool FIFO_PushInline(FIFO_Buffer *fifo, uint8_t data) {
+	uint8_t *slot = &fifo->buffer[FIFO_HeadIndex(fifo)];
+	fifo_index_t count = FIFO_CountInline(fifo);
+	if (count == fifo->size) {
+		if (!fifo->overwrite_enabled) {
+			FIFO_STAT_ADD(fifo, rejects, 1);
+			return false; // Buffer is full, and overwriting is disabled
+		}
+		FIFO_AdvanceTail(fifo, 1);	// Overwrite: discard the oldest byte
+		FIFO_STAT_ADD(fifo, overwrites, 1);
+		count--;
+	}
+	FIFO_AdvanceHead(fifo, 1);
+	FIFO_STAT_ADD(fifo, pushes, 1);
+	FIFO_STAT_PEAK(fifo, count + 1);
+	fifo_index_t trigger = fifo->raise_trigger;
+	*slot = data;
+	if ((fifo_index_t)(count + 1) > trigger) {
+		FIFO_LevelCrossed(fifo, count + 1);
+	}
+	return true;
+}
+
+/**
+ * @brief Inline version of FIFO_PushOverwrite().
+ * 
+ * Orders the field accesses around the byte store like FIFO_PushInline().
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param data The byte to push into the buffer.
+ */
+static inline void FIFO_PushOverwriteInline(FIFO_Buffer *fifo, uint8_t data) {
+	uint8_t *slot = &fifo->buffer[FIFO_HeadIndex(fifo)];
+	fifo_index_t count = FIFO_CountInline(fifo);
+	if (count == fifo->size) {
+		FIFO_AdvanceTail(fifo, 1);	// Overwrite oldest data
+		FIFO_STAT_ADD(fifo, overwrites, 1);
+		count--;
+	}
+	FIFO_AdvanceHead(fifo, 1);
+	FIFO_STAT_ADD(fifo, pushes, 1);
+	FIFO_STAT_PEAK(fifo, count + 1);
+	fifo_index_t trigger = fifo->raise_trigger;
+	*slot = data;
+	if ((fifo_index_t)(count + 1) > trigger) {
+		FIFO_LevelCrossed(fifo, count + 1);
+	}
+}
+
+/**
+ * @brief Inline version of FIFO_Pop().
+ * 
+ * Like FIFO_PushInline(), all fields are read and written before the byte is stored
+ * through `data`, which may alias the FIFO structure.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param data Pointer to store the popped byte.
+ * @return true if successful, false if the buffer is empty.
+ */
+static inline bool FIFO_PopInline(FIFO_Buffer *fifo, uint8_t *data) {
+	fifo_index_t count = FIFO_CountInline(fifo);
+	if (count == 0) {
+		FIFO_STAT_ADD(fifo, empty_pops, 1);
+		return false; // Buffer is empty
+	}
+	const uint8_t *slot = &fifo->buffer[FIFO_TailIndex(fifo)];
+	FIFO_AdvanceTail(fifo, 1);
+	FIFO_STAT_ADD(fifo, pops, 1);
+	fifo_index_t trigger = fifo->lower_trigger;
+	*data = *slot;
+	if ((fifo_index_t)(count - 1) < trigger) {
+		FIFO_LevelCrossed(fifo, count - 1);
+	}
+	return true;
+}
+
+/**
+ * @brief Inline version of FIFO_Peek().
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param index Index of the byte to peek at (0 for the oldest byte).
+ * @param data Pointer to store the peeked byte.
+ * @return true if successful, false if the index is out of bounds.
+ */
+static inline bool FIFO_PeekInline(const FIFO_Buffer *fifo, fifo_index_t index, uint8_t *data) {
+	if (index >= FIFO_CountInline(fifo)) {
+		return false; // Index out of bounds
+	}
+	*data = fifo->buffer[FIFO_Offset(fifo, FIFO_TailIndex(fifo), index)];
+	return true;
+}
+
+#endif /* FIFO_BUFFER_INLINE_H_ */
@@ -0,0 +1,43 @@
+#ifndef FIFO_CRC_H_
+#define FIFO_CRC_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * CRC kernels for frame integrity checks.
+ *
+ * - CRC-16-CCITT (polynomial 0x1021, initial value 0xFFFF, not reflected, no final
+ *   XOR; check value 0x29B1 for "123456789").
+ * - CRC-32C (Castagnoli, reflected polynomial 0x82F63B78, initial value and final XOR
+ *   0xFFFFFFFF; check value 0xE3069283 for "123456789").
+ *
+ * Both use constant slicing-by-8 tables of 4 KB and 8 KB, stored in read-only data
+ * (flash on AVR) and shared by all threads without initialization. Define
+ * FIFO_CRC_SLICES=1 for classic byte-at-a-time tables of 512 bytes and 1 KB instead (the
+ * default on AVR). On x86 CPUs with SSE4.2, CRC-32C uses the crc32 instruction instead,
+ * see FIFO_SIMD_GetLevel().
+ *
+ * The Update functions can be called once per segment, e.g. for the two halves of a
+ * wrapped ring: start with the initial value, feed each segment, then apply Final.
+ */
+#ifndef FIFO_CRC_SLICES
+#if defined(__AVR__)
+#define FIFO_CRC_SLICES			1
+#else
+#define FIFO_CRC_SLICES			8
+#endif
+#endif
+
+#if FIFO_CRC_SLICES != 1 && FIFO_CRC_SLICES != 8
+#error "FIFO_CRC_SLICES must be 1 or 8"
+#endif
+
+#define FIFO_CRC16_INITIAL		0xFFFFu
+#define FIFO_CRC32C_INITIAL		0xFFFFFFFFu
+
+uint16_t FIFO_CRC16_Update(uint16_t crc, const uint8_t *data, size_t length);
+uint32_t FIFO_CRC32C_Update(uint32_t crc, const uint8_t *data, size_t length);
+uint32_t FIFO_CRC32C_Final(uint32_t crc);
+
+#endif /* FIFO_CRC_H_ */
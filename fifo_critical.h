@@ -0,0 +1,162 @@
+#ifndef FIFO_CRITICAL_H_
+#define FIFO_CRITICAL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Critical-section backend used by FIFO_PushSafe() and FIFO_PopSafe().
+ *
+ * Select it at build time with -DFIFO_CRITICAL_BACKEND=<value>:
+ *
+ * - FIFO_CRITICAL_AVR:      save SREG and disable interrupts (default on AVR)
+ * - FIFO_CRITICAL_PTHREAD:  one pthread mutex per FIFO (default on other Unix hosts)
+ * - FIFO_CRITICAL_SPINLOCK: one C11 atomic_flag spinlock per FIFO, for short sections
+ *                           between threads on different cores
+ * - FIFO_CRITICAL_NONE:     no mutual exclusion, only a sequentially consistent fence;
+ *                           for FIFOs owned by one thread, or to measure the bare cost.
+ *                           Use FIFO_SPSC_Buffer for lock-free producer/consumer pairs.
+ *
+ * Backends that need per-FIFO state set FIFO_CRITICAL_HAS_LOCK, and FIFO_Buffer then
+ * carries a `fifo_critical_lock_t lock` field. Other targets must pick a backend
+ * explicitly, since a spinlock shared with an interrupt handler would deadlock.
+ */
+#define FIFO_CRITICAL_NONE		0
+#define FIFO_CRITICAL_AVR		1
+#define FIFO_CRITICAL_PTHREAD	2
+#define FIFO_CRITICAL_SPINLOCK	3
+
+#ifndef FIFO_CRITICAL_BACKEND
+#if defined(__AVR__)
+#define FIFO_CRITICAL_BACKEND FIFO_CRITICAL_AVR
+#elif defined(__unix__) || defined(__APPLE__)
+#define FIFO_CRITICAL_BACKEND FIFO_CRITICAL_PTHREAD
+#else
+#error "Define FIFO_CRITICAL_BACKEND to one of the FIFO_CRITICAL_* backends for this target"
+#endif
+#endif
+
+#if FIFO_CRITICAL_BACKEND == FIFO_CRITICAL_AVR
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#define FIFO_CRITICAL_NAME		"avr"
+#define FIFO_CRITICAL_HAS_LOCK	0
+
+typedef uint8_t fifo_critical_state_t;	///< Saved SREG, including the global interrupt flag
+
+static inline void FIFO_CriticalInit(void *lock) {
+	(void)lock;
+}
+
+static inline void FIFO_CriticalDestroy(void *lock) {
+	(void)lock;
+}
+
+static inline fifo_critical_state_t FIFO_CriticalEnter(void *lock) {
+	(void)lock;
+	uint8_t sreg = SREG; // Save the global interrupt flag
+	cli(); // Disable interrupts
+	return sreg;
+}
+
+static inline void FIFO_CriticalExit(void *lock, fifo_critical_state_t sreg) {
+	(void)lock;
+	SREG = sreg; // Restore the interrupt flag
+}
+
+#elif FIFO_CRITICAL_BACKEND == FIFO_CRITICAL_PTHREAD
+
+#include <pthread.h>
+
+#define FIFO_CRITICAL_NAME		"pthread"
+#define FIFO_CRITICAL_HAS_LOCK	1
+
+typedef pthread_mutex_t fifo_critical_lock_t;
+typedef uint8_t fifo_critical_state_t;	///< Unused, a mutex has no state to restore
+
+static inline void FIFO_CriticalInit(fifo_critical_lock_t *lock) {
+	pthread_mutex_init(lock, NULL);
+}
+
+static inline void FIFO_CriticalDestroy(fifo_critical_lock_t *lock) {
+	pthread_mutex_destroy(lock);
+}
+
+static inline fifo_critical_state_t FIFO_CriticalEnter(fifo_critical_lock_t *lock) {
+	pthread_mutex_lock(lock);
+	return 0;
+}
+
+static inline void FIFO_CriticalExit(fifo_critical_lock_t *lock, fifo_critical_state_t state) {
+	(void)state;
+	pthread_mutex_unlock(lock);
+}
+
+#elif FIFO_CRITICAL_BACKEND == FIFO_CRITICAL_SPINLOCK
+
+#include <stdatomic.h>
+
+#define FIFO_CRITICAL_NAME		"spinlock"
+#define FIFO_CRITICAL_HAS_LOCK	1
+
+typedef atomic_flag fifo_critical_lock_t;
+typedef uint8_t fifo_critical_state_t;	///< Unused, a spinlock has no state to restore
+
+static inline void FIFO_CriticalInit(fifo_critical_lock_t *lock) {
+	atomic_flag_clear_explicit(lock, memory_order_release);
+}
+
+static inline void FIFO_CriticalDestroy(fifo_critical_lock_t *lock) {
+	(void)lock;
+}
+
+static inline fifo_critical_state_t FIFO_CriticalEnter(fifo_critical_lock_t *lock) {
+	while (atomic_flag_test_and_set_explicit(lock, memory_order_acquire)) {
+#if defined(__x86_64__) || defined(__i386__)
+		__builtin_ia32_pause();	// Be gentle with the sibling hyper-thread while spinning
+#endif
+	}
+	return 0;
+}
+
+static inline void FIFO_CriticalExit(fifo_critical_lock_t *lock, fifo_critical_state_t state) {
+	(void)state;
+	atomic_flag_clear_explicit(lock, memory_order_release);
+}
+
+#elif FIFO_CRITICAL_BACKEND == FIFO_CRITICAL_NONE
+
+#include <stdatomic.h>
+
+#define FIFO_CRITICAL_NAME		"none"
+#define FIFO_CRITICAL_HAS_LOCK	0
+
+typedef uint8_t fifo_critical_state_t;	///< Unused
+
+static inline void FIFO_CriticalInit(void *lock) {
+	(void)lock;
+}
+
+static inline void FIFO_CriticalDestroy(void *lock) {
+	(void)lock;
+}
+
+static inline fifo_critical_state_t FIFO_CriticalEnter(void *lock) {
+	(void)lock;
+	atomic_thread_fence(memory_order_seq_cst);
+	return 0;
+}
+
+static inline void FIFO_CriticalExit(void *lock, fifo_critical_state_t state) {
+	(void)lock;
+	(void)state;
+	atomic_thread_fence(memory_order_seq_cst);
+}
+
+#else
+#error "Unknown FIFO_CRITICAL_BACKEND"
+#endif
+
+#endif /* FIFO_CRITICAL_H_ */
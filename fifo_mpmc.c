@@ -0,0 +1,212 @@
+#include "fifo_mpmc.h"
+#include <string.h>
+
+/**
+ * @brief Returns the sequence counter at the start of a cell.
+ * 
+ * @param queue Pointer to the MPMC queue.
+ * @param position Free-running head or tail position that selects the cell.
+ * @return Pointer to the cell's sequence counter.
+ */
+static inline _Atomic fifo_index_t *FIFO_MPMC_Sequence(FIFO_MPMC_Queue *queue, fifo_index_t position) {
+	return (_Atomic fifo_index_t *)&queue->cells[(size_t)(position & queue->mask) * queue->cell_size];
+}
+
+/**
+ * @brief Returns the element storage that follows a cell's sequence counter.
+ * 
+ * @param sequence Pointer to the cell's sequence counter.
+ * @return Pointer to the cell's element bytes.
+ */
+static inline uint8_t *FIFO_MPMC_Element(_Atomic fifo_index_t *sequence) {
+	return (uint8_t *)sequence + sizeof(_Atomic fifo_index_t);
+}
+
+/**
+ * @brief Signed distance from `position` to `sequence` on the free-running counter circle.
+ * 
+ * The counters wrap, so the difference is taken in fifo_index_t and then read as
+ * negative when it lies in the upper half of the range.
+ * 
+ * @param sequence Sequence counter of a cell.
+ * @param position Head or tail position being compared with it.
+ * @return A negative, zero or positive value as `sequence` is behind, at or ahead of `position`.
+ */
+static inline int FIFO_MPMC_Compare(fifo_index_t sequence, fifo_index_t position) {
+	fifo_index_t difference = (fifo_index_t)(sequence - position);
+	if (difference == 0) {
+		return 0;
+	}
+	return (difference > (fifo_index_t)((fifo_index_t)~(fifo_index_t)0 >> 1)) ? -1 : 1;
+}
+
+/**
+ * @brief Initializes an MPMC queue over statically allocated cell storage.
+ * 
+ * The storage must hold `size * FIFO_MPMC_CELL_SIZE(element_size)` bytes and be aligned
+ * for fifo_index_t. Initialization must complete before any thread uses the queue.
+ * 
+ * @param queue Pointer to the MPMC queue structure to initialize.
+ * @param cells Pointer to the cell storage.
+ * @param size Number of cells, must be a power of two and at most a quarter of the index range.
+ * @param element_size Size of one element in bytes.
+ * @return true if initialization was successful, false if the size is invalid.
+ */
+bool FIFO_MPMC_Init(FIFO_MPMC_Queue *queue, void *cells, fifo_index_t size, size_t element_size) {
+	if (size == 0 || (size & (size - 1)) != 0) {
+		return false; // Size is not a power of two
+	}
+	if (size > (fifo_index_t)((fifo_index_t)~(fifo_index_t)0 >> 2)) {
+		return false; // Sequence comparisons need headroom on the counter circle
+	}
+	queue->cells = (uint8_t *)cells;
+	queue->cell_size = FIFO_MPMC_CELL_SIZE(element_size);
+	queue->element_size = element_size;
+	queue->size = size;
+	queue->mask = size - 1;
+	for (fifo_index_t i = 0; i < size; i++) {
+		atomic_init(FIFO_MPMC_Sequence(queue, i), i);	// Cell i is free for the push at position i
+	}
+	atomic_init(&queue->head, 0);
+	atomic_init(&queue->tail, 0);
+	return true;
+}
+
+/**
+ * @brief Initializes an MPMC queue with dynamically allocated cell storage.
+ * 
+ * @param queue Pointer to the MPMC queue.
+ * @param size Number of cells, must be a power of two.
+ * @param element_size Size of one element in bytes.
+ * @return true if initialization was successful, false otherwise.
+ */
+bool FIFO_MPMC_Init_Dynamic(FIFO_MPMC_Queue *queue, fifo_index_t size, size_t element_size) {
+	if (size == 0 || (size & (size - 1)) != 0) {
+		return false; // Size is not a power of two
+	}
+	void *cells = malloc((size_t)size * FIFO_MPMC_CELL_SIZE(element_size));
+	if (cells == NULL) {
+		return false; // Memory allocation failed
+	}
+	if (!FIFO_MPMC_Init(queue, cells, size, element_size)) {
+		free(cells);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Frees the dynamically allocated cell storage.
+ * 
+ * @param queue Pointer to the MPMC queue.
+ */
+void FIFO_MPMC_Free(FIFO_MPMC_Queue *queue) {
+	free(queue->cells);
+	queue->cells = NULL;
+}
+
+/**
+ * @brief Pushes an element into the MPMC queue. Safe to call from any thread.
+ * 
+ * A producer stalled between loading the head and its compare-and-swap while the head
+ * laps the whole index range could claim a stale cell, see FIFO_MPMC_Queue.
+ * 
+ * @param queue Pointer to the MPMC queue.
+ * @param element Pointer to the element to copy into the queue.
+ * @return true if successful, false if the queue is full.
+ */
+bool FIFO_MPMC_Push(FIFO_MPMC_Queue *queue, const void *element) {
+	fifo_index_t position = atomic_load_explicit(&queue->head, memory_order_relaxed);
+	_Atomic fifo_index_t *sequence;
+	for (;;) {
+		sequence = FIFO_MPMC_Sequence(queue, position);
+		int compare = FIFO_MPMC_Compare(atomic_load_explicit(sequence, memory_order_acquire), position);
+		if (compare == 0) {
+			// Cell is free for this lap, try to claim it
+			if (atomic_compare_exchange_weak_explicit(&queue->head, &position, (fifo_index_t)(position + 1),
+				memory_order_relaxed, memory_order_relaxed)) {
+				break;
+			}
+		} else if (compare < 0) {
+			return false; // Cell still holds an element from the previous lap: queue is full
+		} else {
+			position = atomic_load_explicit(&queue->head, memory_order_relaxed); // Another producer won
+		}
+	}
+	memcpy(FIFO_MPMC_Element(sequence), element, queue->element_size);
+	atomic_store_explicit(sequence, (fifo_index_t)(position + 1), memory_order_release);	// Hand over to consumers
+	return true;
+}
+
+/**
+ * @brief Pops an element from the MPMC queue. Safe to call from any thread.
+ * 
+ * A consumer stalled between loading the tail and its compare-and-swap while the tail
+ * laps the whole index range could claim a stale cell, see FIFO_MPMC_Queue.
+ * 
+ * @param queue Pointer to the MPMC queue.
+ * @param element Pointer to store the popped element.
+ * @return true if successful, false if the queue is empty.
+ */
+bool FIFO_MPMC_Pop(FIFO_MPMC_Queue *queue, void *element) {
+	fifo_index_t position = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+	_Atomic fifo_index_t *sequence;
+	for (;;) {
+		sequence = FIFO_MPMC_Sequence(queue, position);
+		int compare = FIFO_MPMC_Compare(atomic_load_explicit(sequence, memory_order_acquire),
+			(fifo_index_t)(position + 1));
+		if (compare == 0) {
+			// Cell holds the element for this position, try to claim it
+			if (atomic_compare_exchange_weak_explicit(&queue->tail, &position, (fifo_index_t)(position + 1),
+				memory_order_relaxed, memory_order_relaxed)) {
+				break;
+			}
+		} else if (compare < 0) {
+			return false; // Cell not filled yet: queue is empty
+		} else {
+			position = atomic_load_explicit(&queue->tail, memory_order_relaxed); // Another consumer won
+		}
+	}
+	memcpy(element, FIFO_MPMC_Element(sequence), queue->element_size);
+	atomic_store_explicit(sequence, (fifo_index_t)(position + queue->size), memory_order_release);	// Free for the next lap
+	return true;
+}
+
+/**
+ * @brief Returns the approximate number of elements in the MPMC queue.
+ * 
+ * The result is a snapshot that may be stale by the time it is used, and it counts
+ * elements whose push or pop is still in progress.
+ * 
+ * @param queue Pointer to the MPMC queue.
+ * @return The number of elements, clamped to the queue size.
+ */
+fifo_index_t FIFO_MPMC_Count(FIFO_MPMC_Queue *queue) {
+	fifo_index_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+	fifo_index_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+	fifo_index_t count = (fifo_index_t)(head - tail);
+	if (FIFO_MPMC_Compare(head, tail) < 0) {
+		return 0; // Tail was read before a pop that the head already reflects
+	}
+	return (count > queue->size) ? queue->size : count;
+}
+
+/**
+ * @brief Checks if the MPMC queue is empty.
+ * 
+ * @param queue Pointer to the MPMC queue.
+ * @return true if empty, false otherwise.
+ */
+bool FIFO_MPMC_IsEmpty(FIFO_MPMC_Queue *queue) {
+	return FIFO_MPMC_Count(queue) == 0;
+}
+
+/**
+ * @brief Checks if the MPMC queue is full.
+ * 
+ * @param queue Pointer to the MPMC queue.
+ * @return true if full, false otherwise.
+ */
+bool FIFO_MPMC_IsFull(FIFO_MPMC_Queue *queue) {
+	return FIFO_MPMC_Count(queue) == queue->size;
+}
@@ -0,0 +1,53 @@
+#ifndef FIFO_MPMC_H_
+#define FIFO_MPMC_H_
+
+#include "fifo_spsc.h"
+
+/**
+ * Bytes used by one cell of an MPMC queue holding elements of `element_size` bytes:
+ * the cell's sequence counter followed by the element, rounded up so that the next
+ * cell's counter stays aligned. Use it to size storage for FIFO_MPMC_Init().
+ */
+#define FIFO_MPMC_CELL_SIZE(element_size) \
+	((sizeof(_Atomic fifo_index_t) + (element_size) + _Alignof(_Atomic fifo_index_t) - 1) \
+	 / _Alignof(_Atomic fifo_index_t) * _Alignof(_Atomic fifo_index_t))
+
+/**
+ * Bounded lock-free multi-producer/multi-consumer queue of fixed-size elements.
+ * 
+ * Every cell carries a sequence counter that tells producers and consumers which lap
+ * of the ring the cell belongs to (Vyukov's bounded MPMC queue). A producer claims a
+ * cell with a compare-and-swap on the head once the cell's sequence equals the head,
+ * copies the element in and advances the sequence; consumers do the mirror image on
+ * the tail. Producers and consumers only contend with their own kind.
+ * Sizes must be a power of two and at most a quarter of the fifo_index_t range.
+ * 
+ * The head, tail and sequence counters wrap with fifo_index_t. A thread stalled between
+ * loading a counter and its compare-and-swap while the others advance it by a whole
+ * index range sees the same value again and can claim a stale cell (the ABA problem
+ * FIFO_MPSC_Buffer has too). With the default 16-bit index that takes only 65536
+ * operations, so prefer a 32-bit or wider fifo_index_t when threads can be preempted.
+ */
+typedef struct {
+	uint8_t *cells;						///< Pointer to the cell array
+	size_t cell_size;					///< Bytes per cell, see FIFO_MPMC_CELL_SIZE()
+	size_t element_size;				///< Bytes per element
+	fifo_index_t size;					///< Total number of cells, a power of two
+	fifo_index_t mask;					///< size - 1
+	_Alignas(FIFO_CACHE_LINE_SIZE)
+	_Atomic fifo_index_t head;			///< Next cell to fill, shared by the producers
+	_Alignas(FIFO_CACHE_LINE_SIZE)
+	_Atomic fifo_index_t tail;			///< Next cell to drain, shared by the consumers
+} FIFO_MPMC_Queue;
+
+
+bool FIFO_MPMC_Init(FIFO_MPMC_Queue *queue, void *cells, fifo_index_t size, size_t element_size);
+bool FIFO_MPMC_Init_Dynamic(FIFO_MPMC_Queue *queue, fifo_index_t size, size_t element_size);
+void FIFO_MPMC_Free(FIFO_MPMC_Queue *queue);
+bool FIFO_MPMC_Push(FIFO_MPMC_Queue *queue, const void *element);
+bool FIFO_MPMC_Pop(FIFO_MPMC_Queue *queue, void *element);
+fifo_index_t FIFO_MPMC_Count(FIFO_MPMC_Queue *queue);
+bool FIFO_MPMC_IsEmpty(FIFO_MPMC_Queue *queue);
+bool FIFO_MPMC_IsFull(FIFO_MPMC_Queue *queue);
+
+#endif /* FIFO_MPMC_H_ */
@@ -0,0 +1,150 @@
+#include "fifo_mpsc.h"
+
+/**
+ * @brief Initializes a lock-free MPSC FIFO buffer over a statically allocated slot array.
+ * 
+ * Initialization must complete before any producer or consumer thread uses the buffer.
+ * 
+ * @param fifo Pointer to the MPSC FIFO buffer structure to initialize.
+ * @param slots Pointer to a statically allocated slot array to be used as the buffer.
+ * @param size Number of slots in the array, must be a power of two and at most a quarter of the index range.
+ * @return true if initialization was successful, false if the size is invalid.
+ */
+bool FIFO_MPSC_Init(FIFO_MPSC_Buffer *fifo, FIFO_MPSC_Slot *slots, fifo_index_t size) {
+	if (size == 0 || (size & (size - 1)) != 0) {
+		return false; // Size is not a power of two
+	}
+	if (size > (fifo_index_t)((fifo_index_t)~(fifo_index_t)0 >> 2)) {
+		return false; // Keep the head far from lapping a stalled producer's snapshot
+	}
+	fifo->slots = slots;
+	fifo->size = size;
+	fifo->mask = size - 1;
+	for (fifo_index_t i = 0; i < size; i++) {
+		atomic_init(&slots[i].ready, 0);
+	}
+	atomic_init(&fifo->head, 0);
+	atomic_init(&fifo->tail, 0);
+	return true;
+}
+
+/**
+ * @brief Initializes a lock-free MPSC FIFO buffer with a dynamically allocated slot array.
+ * 
+ * @param fifo Pointer to the MPSC FIFO buffer.
+ * @param size Number of slots, must be a power of two and at most a quarter of the index range.
+ * @return true if initialization was successful, false otherwise.
+ */
+bool FIFO_MPSC_Init_Dynamic(FIFO_MPSC_Buffer *fifo, fifo_index_t size) {
+	if (size == 0 || (size & (size - 1)) != 0) {
+		return false; // Size is not a power of two
+	}
+	FIFO_MPSC_Slot *slots = (FIFO_MPSC_Slot *)malloc((size_t)size * sizeof(FIFO_MPSC_Slot));
+	if (slots == NULL) {
+		return false; // Memory allocation failed
+	}
+	if (!FIFO_MPSC_Init(fifo, slots, size)) {
+		free(slots);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Frees the dynamically allocated slot array.
+ * 
+ * @param fifo Pointer to the MPSC FIFO buffer.
+ */
+void FIFO_MPSC_Free(FIFO_MPSC_Buffer *fifo) {
+	free(fifo->slots);
+	fifo->slots = NULL;
+}
+
+/**
+ * @brief Pushes a byte into the MPSC FIFO buffer. Safe to call from any number of producers.
+ * 
+ * The producer claims the next slot with a compare-and-swap on the head, which fails
+ * instead of overshooting when the buffer is full. Each attempt loads the tail first and
+ * the head after it, so the head is never older than the tail it is compared with and a
+ * full buffer is never reported spuriously. A producer stalled between its loads and its
+ * compare-and-swap while the head laps the whole index range could still claim a stale
+ * slot, so prefer a wide fifo_index_t for many preemptible producers.
+ * 
+ * @param fifo Pointer to the MPSC FIFO buffer.
+ * @param data The byte to push into the buffer.
+ * @return true if successful, false if the buffer is full.
+ */
+bool FIFO_MPSC_Push(FIFO_MPSC_Buffer *fifo, uint8_t data) {
+	fifo_index_t head;
+	do {
+		fifo_index_t tail = atomic_load_explicit(&fifo->tail, memory_order_acquire);
+		head = atomic_load_explicit(&fifo->head, memory_order_relaxed);	// Not older than `tail`
+		if ((fifo_index_t)(head - tail) >= fifo->size) {
+			return false; // Buffer is full
+		}
+	} while (!atomic_compare_exchange_weak_explicit(&fifo->head, &head, (fifo_index_t)(head + 1),
+		memory_order_relaxed, memory_order_relaxed));
+
+	FIFO_MPSC_Slot *slot = &fifo->slots[head & fifo->mask];
+	slot->data = data;
+	atomic_store_explicit(&slot->ready, 1, memory_order_release);	// Publish this slot only
+	return true;
+}
+
+/**
+ * @brief Pops a byte from the MPSC FIFO buffer. Single consumer only.
+ * 
+ * Bytes are returned in claim order. If the producer that claimed the oldest slot has
+ * not published it yet, the buffer reports empty until it does, even if later slots are
+ * already filled.
+ * 
+ * @param fifo Pointer to the MPSC FIFO buffer.
+ * @param data Pointer to store the popped byte.
+ * @return true if successful, false if no published byte is available.
+ */
+bool FIFO_MPSC_Pop(FIFO_MPSC_Buffer *fifo, uint8_t *data) {
+	fifo_index_t tail = atomic_load_explicit(&fifo->tail, memory_order_relaxed);
+	FIFO_MPSC_Slot *slot = &fifo->slots[tail & fifo->mask];
+	if (!atomic_load_explicit(&slot->ready, memory_order_acquire)) {
+		return false; // Buffer is empty or the oldest slot is not published yet
+	}
+	*data = slot->data;
+	atomic_store_explicit(&slot->ready, 0, memory_order_relaxed);
+	atomic_store_explicit(&fifo->tail, (fifo_index_t)(tail + 1), memory_order_release);
+	return true;
+}
+
+/**
+ * @brief Returns the number of claimed slots in the MPSC FIFO buffer.
+ * 
+ * This includes slots that producers have claimed but not yet published.
+ * 
+ * @param fifo Pointer to the MPSC FIFO buffer.
+ * @return The number of bytes stored or being stored.
+ */
+fifo_index_t FIFO_MPSC_Count(FIFO_MPSC_Buffer *fifo) {
+	fifo_index_t tail = atomic_load_explicit(&fifo->tail, memory_order_acquire);
+	fifo_index_t head = atomic_load_explicit(&fifo->head, memory_order_acquire);
+	return (fifo_index_t)(head - tail);
+}
+
+/**
+ * @brief Checks if the MPSC FIFO buffer has no byte ready for the consumer.
+ * 
+ * @param fifo Pointer to the MPSC FIFO buffer.
+ * @return true if empty, false otherwise.
+ */
+bool FIFO_MPSC_IsEmpty(FIFO_MPSC_Buffer *fifo) {
+	fifo_index_t tail = atomic_load_explicit(&fifo->tail, memory_order_relaxed);
+	return !atomic_load_explicit(&fifo->slots[tail & fifo->mask].ready, memory_order_acquire);
+}
+
+/**
+ * @brief Checks if the MPSC FIFO buffer is full.
+ * 
+ * @param fifo Pointer to the MPSC FIFO buffer.
+ * @return true if full, false otherwise.
+ */
+bool FIFO_MPSC_IsFull(FIFO_MPSC_Buffer *fifo) {
+	return FIFO_MPSC_Count(fifo) >= fifo->size;
+}
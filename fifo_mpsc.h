@@ -0,0 +1,44 @@
+#ifndef FIFO_MPSC_H_
+#define FIFO_MPSC_H_
+
+#include "fifo_spsc.h"
+
+/**
+ * One element of the MPSC ring. The `ready` flag is what publishes the byte to the
+ * consumer, so a producer that has claimed a slot but not yet filled it never exposes
+ * stale data.
+ */
+typedef struct {
+	_Atomic uint8_t ready;				///< Set by the producer once `data` is written
+	uint8_t data;						///< Stored byte
+} FIFO_MPSC_Slot;
+
+/**
+ * Lock-free multi-producer/single-consumer FIFO buffer.
+ * 
+ * Producers claim a slot by advancing the shared head with a compare-and-swap, write
+ * the byte and then set the slot's `ready` flag. The single consumer reads slots in
+ * order and never writes the head, so popping needs no atomic read-modify-write.
+ * Sizes must be a power of two and at most a quarter of the fifo_index_t range.
+ */
+typedef struct {
+	FIFO_MPSC_Slot *slots;				///< Pointer to the circular slot array
+	fifo_index_t size;					///< Total number of slots, a power of two
+	fifo_index_t mask;					///< size - 1
+	_Alignas(FIFO_CACHE_LINE_SIZE)
+	_Atomic fifo_index_t head;			///< Next slot to claim, shared by the producers
+	_Alignas(FIFO_CACHE_LINE_SIZE)
+	_Atomic fifo_index_t tail;			///< Next slot to read, owned by the consumer
+} FIFO_MPSC_Buffer;
+
+
+bool FIFO_MPSC_Init(FIFO_MPSC_Buffer *fifo, FIFO_MPSC_Slot *slots, fifo_index_t size);
+bool FIFO_MPSC_Init_Dynamic(FIFO_MPSC_Buffer *fifo, fifo_index_t size);
+void FIFO_MPSC_Free(FIFO_MPSC_Buffer *fifo);
+bool FIFO_MPSC_Push(FIFO_MPSC_Buffer *fifo, uint8_t data);
+bool FIFO_MPSC_Pop(FIFO_MPSC_Buffer *fifo, uint8_t *data);
+fifo_index_t FIFO_MPSC_Count(FIFO_MPSC_Buffer *fifo);
+bool FIFO_MPSC_IsEmpty(FIFO_MPSC_Buffer *fifo);
+bool FIFO_MPSC_IsFull(FIFO_MPSC_Buffer *fifo);
+
+#endif /* FIFO_MPSC_H_ */
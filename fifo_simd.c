@@ -0,0 +1,235 @@
+#include "fifo_simd.h"
+
+/**
+ * Helpers shared by several kernels are forced inline, so they are compiled with the
+ * instruction set of each kernel. An AVX2 kernel calling out-of-line SSE code would pay
+ * an AVX/SSE transition penalty on every call.
+ */
+#if defined(__GNUC__)
+#define FIFO_SIMD_INLINE static inline __attribute__((always_inline))
+#else
+#define FIFO_SIMD_INLINE static inline
+#endif
+
+#if FIFO_SIMD_X86
+#include <immintrin.h>
+#include <stdatomic.h>
+
+/**
+ * Highest level the CPU supports, or -1 before the first call to FIFO_SIMD_GetLevel().
+ * Lowered by FIFO_SIMD_SetLevel(). Threads may detect it concurrently; they all store
+ * the same value, so relaxed ordering is enough.
+ */
+static _Atomic int fifo_simd_level = -1;
+
+/**
+ * @brief Detects the instruction set supported by the CPU.
+ *
+ * @return The highest usable level.
+ */
+static FIFO_SIMD_Level FIFO_SIMD_Detect(void) {
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("sse4.2")) {
+		return FIFO_SIMD_AVX2;
+	}
+	if (__builtin_cpu_supports("sse4.2")) {
+		return FIFO_SIMD_SSE42;
+	}
+#if defined(__SSE2__)
+	return FIFO_SIMD_SSE2;
+#else
+	return __builtin_cpu_supports("sse2") ? FIFO_SIMD_SSE2 : FIFO_SIMD_SCALAR;
+#endif
+}
+#endif
+
+/**
+ * @brief Returns the instruction set used by the kernels.
+ *
+ * @return The level detected at the first call, or the one set with FIFO_SIMD_SetLevel().
+ */
+FIFO_SIMD_Level FIFO_SIMD_GetLevel(void) {
+#if FIFO_SIMD_X86
+	int level = atomic_load_explicit(&fifo_simd_level, memory_order_relaxed);
+	if (level < 0) {
+		level = FIFO_SIMD_Detect();
+		atomic_store_explicit(&fifo_simd_level, level, memory_order_relaxed);
+	}
+	return (FIFO_SIMD_Level)level;
+#else
+	return FIFO_SIMD_SCALAR;
+#endif
+}
+
+/**
+ * @brief Restricts the kernels to an instruction set, e.g. to compare them in a benchmark.
+ *
+ * Levels above what the CPU supports are lowered to the highest supported one. Call it
+ * before other threads use the kernels.
+ *
+ * @param level Highest level to use.
+ * @return The level that will actually be used.
+ */
+FIFO_SIMD_Level FIFO_SIMD_SetLevel(FIFO_SIMD_Level level) {
+#if FIFO_SIMD_X86
+	FIFO_SIMD_Level supported = FIFO_SIMD_Detect();
+	level = (level < supported) ? level : supported;
+	atomic_store_explicit(&fifo_simd_level, level, memory_order_relaxed);
+	return level;
+#else
+	(void)level;
+	return FIFO_SIMD_SCALAR;
+#endif
+}
+
+/**
+ * @brief Scalar version of FIFO_SIMD_FindByte().
+ */
+FIFO_SIMD_INLINE size_t FIFO_SIMD_FindByteScalar(const uint8_t *data, size_t length, uint8_t value) {
+	for (size_t i = 0; i < length; i++) {
+		if (data[i] == value) {
+			return i;
+		}
+	}
+	return length;
+}
+
+#if FIFO_SIMD_X86
+/**
+ * @brief SSE2 version of FIFO_SIMD_FindByte(), 16 bytes per compare.
+ */
+__attribute__((target("sse2")))
+FIFO_SIMD_INLINE size_t FIFO_SIMD_FindByteSse2(const uint8_t *data, size_t length, uint8_t value) {
+	const __m128i needle = _mm_set1_epi8((char)value);
+	size_t i = 0;
+	for (; i + 16 <= length; i += 16) {
+		__m128i chunk = _mm_loadu_si128((const __m128i *)&data[i]);
+		unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle));
+		if (mask != 0) {
+			return i + (size_t)__builtin_ctz(mask);
+		}
+	}
+	return i + FIFO_SIMD_FindByteScalar(&data[i], length - i, value);
+}
+
+/**
+ * @brief AVX2 version of FIFO_SIMD_FindByte(), 32 bytes per compare.
+ */
+__attribute__((target("avx2")))
+static size_t FIFO_SIMD_FindByteAvx2(const uint8_t *data, size_t length, uint8_t value) {
+	const __m256i needle = _mm256_set1_epi8((char)value);
+	size_t i = 0;
+	for (; i + 32 <= length; i += 32) {
+		__m256i chunk = _mm256_loadu_si256((const __m256i *)&data[i]);
+		unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle));
+		if (mask != 0) {
+			return i + (size_t)__builtin_ctz(mask);
+		}
+	}
+	return i + FIFO_SIMD_FindByteSse2(&data[i], length - i, value);
+}
+#endif
+
+/**
+ * @brief Finds the first occurrence of a byte in a contiguous array.
+ *
+ * @param data Array to search.
+ * @param length Number of bytes in the array.
+ * @param value Byte to look for.
+ * @return Index of the first byte equal to `value`, or `length` if there is none.
+ */
+size_t FIFO_SIMD_FindByte(const uint8_t *data, size_t length, uint8_t value) {
+#if FIFO_SIMD_X86
+	switch (FIFO_SIMD_GetLevel()) {
+	case FIFO_SIMD_AVX2:
+		return FIFO_SIMD_FindByteAvx2(data, length, value);
+	case FIFO_SIMD_SSE42:
+	case FIFO_SIMD_SSE2:
+		return FIFO_SIMD_FindByteSse2(data, length, value);
+	default:
+		break;
+	}
+#endif
+	return FIFO_SIMD_FindByteScalar(data, length, value);
+}
+
+/**
+ * @brief Scalar version of FIFO_SIMD_Xor().
+ */
+FIFO_SIMD_INLINE uint8_t FIFO_SIMD_XorScalar(const uint8_t *data, size_t length) {
+	uint8_t checksum = 0;
+	for (size_t i = 0; i < length; i++) {
+		checksum ^= data[i];
+	}
+	return checksum;
+}
+
+#if FIFO_SIMD_X86
+/**
+ * @brief Folds the 16 lanes of a vector into one byte with XOR.
+ */
+__attribute__((target("sse2")))
+FIFO_SIMD_INLINE uint8_t FIFO_SIMD_XorLanes(__m128i lanes) {
+	lanes = _mm_xor_si128(lanes, _mm_srli_si128(lanes, 8));
+	lanes = _mm_xor_si128(lanes, _mm_srli_si128(lanes, 4));
+	lanes = _mm_xor_si128(lanes, _mm_srli_si128(lanes, 2));
+	lanes = _mm_xor_si128(lanes, _mm_srli_si128(lanes, 1));
+	return (uint8_t)_mm_cvtsi128_si32(lanes);
+}
+
+/**
+ * @brief SSE2 version of FIFO_SIMD_Xor(), 16 bytes per step.
+ */
+__attribute__((target("sse2")))
+FIFO_SIMD_INLINE uint8_t FIFO_SIMD_XorSse2(const uint8_t *data, size_t length) {
+	__m128i lanes = _mm_setzero_si128();
+	size_t i = 0;
+	for (; i + 16 <= length; i += 16) {
+		lanes = _mm_xor_si128(lanes, _mm_loadu_si128((const __m128i *)&data[i]));
+	}
+	return FIFO_SIMD_XorLanes(lanes) ^ FIFO_SIMD_XorScalar(&data[i], length - i);
+}
+
+/**
+ * @brief AVX2 version of FIFO_SIMD_Xor(), 64 bytes per step in two independent accumulators.
+ */
+__attribute__((target("avx2")))
+static uint8_t FIFO_SIMD_XorAvx2(const uint8_t *data, size_t length) {
+	__m256i even = _mm256_setzero_si256();
+	__m256i odd = _mm256_setzero_si256();
+	size_t i = 0;
+	for (; i + 64 <= length; i += 64) {
+		even = _mm256_xor_si256(even, _mm256_loadu_si256((const __m256i *)&data[i]));
+		odd = _mm256_xor_si256(odd, _mm256_loadu_si256((const __m256i *)&data[i + 32]));
+	}
+	if (i + 32 <= length) {
+		even = _mm256_xor_si256(even, _mm256_loadu_si256((const __m256i *)&data[i]));
+		i += 32;
+	}
+	even = _mm256_xor_si256(even, odd);
+	__m128i lanes = _mm_xor_si128(_mm256_castsi256_si128(even), _mm256_extracti128_si256(even, 1));
+	return FIFO_SIMD_XorLanes(lanes) ^ FIFO_SIMD_XorSse2(&data[i], length - i);
+}
+#endif
+
+/**
+ * @brief Computes the XOR of all bytes in a contiguous array.
+ * 
+ * @param data Array to fold.
+ * @param length Number of bytes in the array.
+ * @return The XOR of the bytes, 0 for an empty array.
+ */
+uint8_t FIFO_SIMD_Xor(const uint8_t *data, size_t length) {
+#if FIFO_SIMD_X86
+	switch (FIFO_SIMD_GetLevel()) {
+	case FIFO_SIMD_AVX2:
+		return FIFO_SIMD_XorAvx2(data, length);
+	case FIFO_SIMD_SSE42:
+	case FIFO_SIMD_SSE2:
+		return FIFO_SIMD_XorSse2(data, length);
+	default:
+		break;
+	}
+#endif
+	return FIFO_SIMD_XorScalar(data, length);
+}
@@ -0,0 +1,36 @@
+#ifndef FIFO_SIMD_H_
+#define FIFO_SIMD_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Byte-scanning kernels used by FIFO_FindByte() and the UART message parser. The
+ * selected level also controls the CRC-32C instruction used by fifo_crc.c.
+ *
+ * On x86 the kernels use SSE2, or AVX2 when the CPU reports it at run time; AVX2 code
+ * is compiled with a target attribute, so no special compiler flags are needed. Other
+ * targets, including AVR, use the scalar loops.
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FIFO_SIMD_X86 1
+#else
+#define FIFO_SIMD_X86 0
+#endif
+
+/**
+ * Instruction set used by the kernels, from slowest to fastest.
+ */
+typedef enum {
+	FIFO_SIMD_SCALAR = 0,	///< Plain C loops
+	FIFO_SIMD_SSE2,			///< 16 bytes per step
+	FIFO_SIMD_SSE42,		///< SSE2 kernels plus the crc32 instruction for CRC-32C
+	FIFO_SIMD_AVX2			///< 32 bytes per step
+} FIFO_SIMD_Level;
+
+FIFO_SIMD_Level FIFO_SIMD_GetLevel(void);
+FIFO_SIMD_Level FIFO_SIMD_SetLevel(FIFO_SIMD_Level level);
+size_t FIFO_SIMD_FindByte(const uint8_t *data, size_t length, uint8_t value);
+uint8_t FIFO_SIMD_Xor(const uint8_t *data, size_t length);
+
+#endif /* FIFO_SIMD_H_ */
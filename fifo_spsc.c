@@ -0,0 +1,376 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE		// syscall() for the futex wait/wake
+#endif
+
+#include "fifo_spsc.h"
+
+#if FIFO_SPSC_WAIT_ENABLED
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief Sleeps on a futex word while it still holds an expected value.
+ * 
+ * @param word Futex word.
+ * @param expected Value observed before deciding to sleep; the call returns at once if it changed.
+ * @param timeout Relative timeout, or NULL to wait without limit.
+ */
+static void FIFO_SPSC_FutexWait(_Atomic uint32_t *word, uint32_t expected, const struct timespec *timeout) {
+	syscall(SYS_futex, (uint32_t *)word, FUTEX_WAIT_PRIVATE, expected, timeout, NULL, 0);
+}
+
+/**
+ * @brief Wakes the thread sleeping on a futex word, if the other side announced one.
+ * 
+ * The full fence orders the caller's preceding release store of head or tail before the
+ * waiter flag is read. The sleeper sets the flag and fences before re-checking head or
+ * tail, so either the sleeper sees the new counter or this side sees the flag.
+ * 
+ * @param event Futex word the other side sleeps on.
+ * @param waiter Flag the other side sets before sleeping.
+ */
+static inline void FIFO_SPSC_Wake(_Atomic uint32_t *event, _Atomic uint32_t *waiter) {
+	atomic_thread_fence(memory_order_seq_cst);
+	if (atomic_load_explicit(waiter, memory_order_relaxed)) {
+		atomic_fetch_add_explicit(event, 1, memory_order_release);
+		syscall(SYS_futex, (uint32_t *)event, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+	}
+}
+#endif
+
+/**
+ * @brief Stores the producer's counter to the shared head and, with FIFO_SPSC_WAIT_ENABLED, wakes a sleeping consumer.
+ * 
+ * @param fifo Pointer to the SPSC FIFO buffer.
+ * @param head Write counter to publish.
+ */
+static inline void FIFO_SPSC_PublishHead(FIFO_SPSC_Buffer *fifo, fifo_index_t head) {
+	atomic_store_explicit(&fifo->head, head, memory_order_release);
+#if FIFO_SPSC_WAIT_ENABLED
+	FIFO_SPSC_Wake(&fifo->data_event, &fifo->data_waiter);
+#endif
+}
+
+/**
+ * @brief Stores the consumer's counter to the shared tail and, with FIFO_SPSC_WAIT_ENABLED, wakes a sleeping producer.
+ * 
+ * @param fifo Pointer to the SPSC FIFO buffer.
+ * @param tail Read counter to publish.
+ */
+static inline void FIFO_SPSC_PublishTail(FIFO_SPSC_Buffer *fifo, fifo_index_t tail) {
+	atomic_store_explicit(&fifo->tail, tail, memory_order_release);
+#if FIFO_SPSC_WAIT_ENABLED
+	FIFO_SPSC_Wake(&fifo->space_event, &fifo->space_waiter);
+#endif
+}
+
+/**
+ * @brief Initializes a lock-free SPSC FIFO buffer over a statically allocated array.
+ * 
+ * The size must be a power of two so that the free-running counters wrap onto the
+ * array with a mask. Initialization must complete before the producer and consumer
+ * threads start using the buffer.
+ * 
+ * @param fifo Pointer to the SPSC FIFO buffer structure to initialize.
+ * @param buffer Pointer to a statically allocated array to be used as the buffer.
+ * @param size Size of the array, must be a power of two.
+ * @return true if initialization was successful, false if the size is not a power of two.
+ */
+bool FIFO_SPSC_Init(FIFO_SPSC_Buffer *fifo, uint8_t *buffer, fifo_index_t size) {
+	if (size == 0 || (size & (size - 1)) != 0) {
+		return false; // Size is not a power of two
+	}
+	fifo->buffer = buffer;
+	fifo->size = size;
+	fifo->mask = size - 1;
+	fifo->batch = 1;
+	atomic_init(&fifo->head, 0);
+	atomic_init(&fifo->tail, 0);
+	fifo->head_local = 0;
+	fifo->tail_local = 0;
+	fifo->tail_cache = 0;
+	fifo->head_cache = 0;
+#if FIFO_SPSC_WAIT_ENABLED
+	atomic_init(&fifo->data_event, 0);
+	atomic_init(&fifo->data_waiter, 0);
+	atomic_init(&fifo->space_event, 0);
+	atomic_init(&fifo->space_waiter, 0);
+#endif
+	return true;
+}
+
+/**
+ * @brief Initializes a lock-free SPSC FIFO buffer with a dynamically allocated array.
+ * 
+ * @param fifo Pointer to the SPSC FIFO buffer.
+ * @param size Size of the buffer, must be a power of two.
+ * @return true if initialization was successful, false otherwise.
+ */
+bool FIFO_SPSC_Init_Dynamic(FIFO_SPSC_Buffer *fifo, fifo_index_t size) {
+	if (size == 0 || (size & (size - 1)) != 0) {
+		return false; // Size is not a power of two
+	}
+	uint8_t *buffer = (uint8_t *)malloc(size * sizeof(uint8_t));
+	if (buffer == NULL) {
+		return false; // Memory allocation failed
+	}
+	return FIFO_SPSC_Init(fifo, buffer, size);
+}
+
+/**
+ * @brief Frees the dynamically allocated buffer memory.
+ * 
+ * @param fifo Pointer to the SPSC FIFO buffer.
+ */
+void FIFO_SPSC_Free(FIFO_SPSC_Buffer *fifo) {
+	free(fifo->buffer);
+	fifo->buffer = NULL;
+}
+
+/**
+ * @brief Sets how many bytes each side accumulates before publishing its counter.
+ * 
+ * Must be called before the producer and consumer threads start.
+ * 
+ * @param fifo Pointer to the SPSC FIFO buffer.
+ * @param batch Number of bytes per publication, from 1 (publish every byte) up to the buffer size.
+ * @return true if successful, false if `batch` is out of range.
+ */
+bool FIFO_SPSC_SetBatch(FIFO_SPSC_Buffer *fifo, fifo_index_t batch) {
+	if (batch == 0 || batch > fifo->size) {
+		return false;
+	}
+	fifo->batch = batch;
+	return true;
+}
+
+/**
+ * @brief Publishes every byte pushed so far to the consumer. Producer side only.
+ * 
+ * @param fifo Pointer to the SPSC FIFO buffer.
+ */
+void FIFO_SPSC_FlushPush(FIFO_SPSC_Buffer *fifo) {
+	FIFO_SPSC_PublishHead(fifo, fifo->head_local);
+}
+
+/**
+ * @brief Returns the space of every byte popped so far to the producer. Consumer side only.
+ * 
+ * @param fifo Pointer to the SPSC FIFO buffer.
+ */
+void FIFO_SPSC_FlushPop(FIFO_SPSC_Buffer *fifo) {
+	FIFO_SPSC_PublishTail(fifo, fifo->tail_local);
+}
+
+/**
+ * @brief Pushes a byte into the SPSC FIFO buffer. Producer side only.
+ * 
+ * The byte is written before the head is published with release ordering, so the
+ * consumer never observes a head that covers an unwritten byte. The consumer's tail is
+ * only loaded when the buffer appears full against the cached copy, and the head is
+ * only published once a full batch of bytes is pending.
+ * 
+ * @param fifo Pointer to the SPSC FIFO buffer.
+ * @param data The byte to push into the buffer.
+ * @return true if successful, false if the buffer is full.
+ */
+bool FIFO_SPSC_Push(FIFO_SPSC_Buffer *fifo, uint8_t data) {
+	fifo_index_t head = fifo->head_local;
+	if ((fifo_index_t)(head - fifo->tail_cache) == fifo->size) {
+		fifo->tail_cache = atomic_load_explicit(&fifo->tail, memory_order_acquire);
+		if ((fifo_index_t)(head - fifo->tail_cache) == fifo->size) {
+			FIFO_SPSC_FlushPush(fifo);	// Let the consumer drain what is pending
+			return false; // Buffer is full
+		}
+	}
+	fifo->buffer[head & fifo->mask] = data;
+	fifo->head_local = ++head;
+	
+	fifo_index_t published = atomic_load_explicit(&fifo->head, memory_order_relaxed);
+	if ((fifo_index_t)(head - published) >= fifo->batch) {
+		FIFO_SPSC_PublishHead(fifo, head);
+	}
+	return true;
+}
+
+/**
+ * @brief Pops a byte from the SPSC FIFO buffer. Consumer side only.
+ * 
+ * The byte is read before the tail is published with release ordering, so the
+ * producer never overwrites a slot that is still being read. The producer's head is
+ * only loaded when the buffer appears empty against the cached copy, and the tail is
+ * only published once a full batch of bytes has been consumed.
+ * 
+ * @param fifo Pointer to the SPSC FIFO buffer.
+ * @param data Pointer to store the popped byte.
+ * @return true if successful, false if the buffer is empty.
+ */
+bool FIFO_SPSC_Pop(FIFO_SPSC_Buffer *fifo, uint8_t *data) {
+	fifo_index_t tail = fifo->tail_local;
+	if (fifo->head_cache == tail) {
+		fifo->head_cache = atomic_load_explicit(&fifo->head, memory_order_acquire);
+		if (fifo->head_cache == tail) {
+			FIFO_SPSC_FlushPop(fifo);	// Give the producer back the space that is pending
+			return false; // Buffer is empty
+		}
+	}
+	*data = fifo->buffer[tail & fifo->mask];
+	fifo->tail_local = ++tail;
+	
+	fifo_index_t published = atomic_load_explicit(&fifo->tail, memory_order_relaxed);
+	if ((fifo_index_t)(tail - published) >= fifo->batch) {
+		FIFO_SPSC_PublishTail(fifo, tail);
+	}
+	return true;
+}
+
+#if FIFO_SPSC_WAIT_ENABLED
+/**
+ * @brief Computes the time left until a deadline.
+ * 
+ * @param deadline Absolute CLOCK_MONOTONIC deadline.
+ * @param remaining Receives the time left.
+ * @return true if time is left, false if the deadline has passed.
+ */
+static bool FIFO_SPSC_Remaining(const struct timespec *deadline, struct timespec *remaining) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	remaining->tv_sec = deadline->tv_sec - now.tv_sec;
+	remaining->tv_nsec = deadline->tv_nsec - now.tv_nsec;
+	if (remaining->tv_nsec < 0) {
+		remaining->tv_nsec += 1000000000L;
+		remaining->tv_sec--;
+	}
+	return remaining->tv_sec >= 0;
+}
+
+/**
+ * @brief Waits on one side of the buffer until `attempt` succeeds or the timeout expires.
+ * 
+ * @param fifo Pointer to the SPSC FIFO buffer.
+ * @param event Futex word the other side bumps when it publishes.
+ * @param waiter Flag announcing this side is about to sleep.
+ * @param attempt Non-blocking push or pop to retry.
+ * @param data Argument passed to `attempt`.
+ * @param timeout_ms Timeout in milliseconds, negative to wait without limit.
+ * @return true if `attempt` succeeded, false on timeout.
+ */
+static bool FIFO_SPSC_Wait(FIFO_SPSC_Buffer *fifo, _Atomic uint32_t *event, _Atomic uint32_t *waiter,
+	bool (*attempt)(FIFO_SPSC_Buffer *, void *), void *data, int32_t timeout_ms) {
+	struct timespec deadline;
+	if (timeout_ms >= 0) {
+		clock_gettime(CLOCK_MONOTONIC, &deadline);
+		deadline.tv_sec += timeout_ms / 1000;
+		deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+		if (deadline.tv_nsec >= 1000000000L) {
+			deadline.tv_nsec -= 1000000000L;
+			deadline.tv_sec++;
+		}
+	}
+	
+	for (;;) {
+		if (attempt(fifo, data)) {
+			return true;
+		}
+		
+		uint32_t observed = atomic_load_explicit(event, memory_order_acquire);
+		atomic_store_explicit(waiter, 1, memory_order_relaxed);
+		atomic_thread_fence(memory_order_seq_cst);	// Pairs with the fence in FIFO_SPSC_Wake()
+		if (attempt(fifo, data)) {
+			atomic_store_explicit(waiter, 0, memory_order_relaxed);
+			return true;
+		}
+		
+		struct timespec remaining;
+		if (timeout_ms >= 0 && !FIFO_SPSC_Remaining(&deadline, &remaining)) {
+			atomic_store_explicit(waiter, 0, memory_order_relaxed);
+			return false; // Timed out
+		}
+		FIFO_SPSC_FutexWait(event, observed, (timeout_ms >= 0) ? &remaining : NULL);
+		atomic_store_explicit(waiter, 0, memory_order_relaxed);
+	}
+}
+
+/**
+ * @brief Adapts FIFO_SPSC_Push() to the FIFO_SPSC_Wait() retry callback.
+ */
+static bool FIFO_SPSC_TryPush(FIFO_SPSC_Buffer *fifo, void *data) {
+	return FIFO_SPSC_Push(fifo, *(const uint8_t *)data);
+}
+
+/**
+ * @brief Adapts FIFO_SPSC_Pop() to the FIFO_SPSC_Wait() retry callback.
+ */
+static bool FIFO_SPSC_TryPop(FIFO_SPSC_Buffer *fifo, void *data) {
+	return FIFO_SPSC_Pop(fifo, (uint8_t *)data);
+}
+
+/**
+ * @brief Pushes a byte, sleeping while the buffer is full. Producer side only.
+ * 
+ * The thread sleeps on a futex and is woken by the consumer when it publishes freed
+ * space. With batching enabled the wake-up comes once the consumer publishes its tail.
+ * 
+ * @param fifo Pointer to the SPSC FIFO buffer.
+ * @param data The byte to push into the buffer.
+ * @param timeout_ms Maximum time to wait in milliseconds, or a negative value to wait forever.
+ * @return true if successful, false if the buffer stayed full until the timeout.
+ */
+bool FIFO_SPSC_PushWait(FIFO_SPSC_Buffer *fifo, uint8_t data, int32_t timeout_ms) {
+	return FIFO_SPSC_Wait(fifo, &fifo->space_event, &fifo->space_waiter, FIFO_SPSC_TryPush, &data, timeout_ms);
+}
+
+/**
+ * @brief Pops a byte, sleeping while the buffer is empty. Consumer side only.
+ * 
+ * The thread sleeps on a futex and is woken by the producer when it publishes new
+ * bytes. With batching enabled the wake-up comes once the producer publishes its head,
+ * so the producer should call FIFO_SPSC_FlushPush() when it goes idle.
+ * 
+ * @param fifo Pointer to the SPSC FIFO buffer.
+ * @param data Pointer to store the popped byte.
+ * @param timeout_ms Maximum time to wait in milliseconds, or a negative value to wait forever.
+ * @return true if successful, false if the buffer stayed empty until the timeout.
+ */
+bool FIFO_SPSC_PopWait(FIFO_SPSC_Buffer *fifo, uint8_t *data, int32_t timeout_ms) {
+	return FIFO_SPSC_Wait(fifo, &fifo->data_event, &fifo->data_waiter, FIFO_SPSC_TryPop, data, timeout_ms);
+}
+#endif
+
+/**
+ * @brief Returns the number of bytes in the SPSC FIFO buffer.
+ * 
+ * When called while the other side is running the result is a snapshot: it can only
+ * grow on the consumer side and only shrink on the producer side. Only published bytes
+ * are counted.
+ * 
+ * @param fifo Pointer to the SPSC FIFO buffer.
+ * @return The number of bytes currently stored.
+ */
+fifo_index_t FIFO_SPSC_Count(FIFO_SPSC_Buffer *fifo) {
+	fifo_index_t tail = atomic_load_explicit(&fifo->tail, memory_order_acquire);
+	fifo_index_t head = atomic_load_explicit(&fifo->head, memory_order_acquire);
+	return (fifo_index_t)(head - tail);
+}
+
+/**
+ * @brief Checks if the SPSC FIFO buffer is empty.
+ * 
+ * @param fifo Pointer to the SPSC FIFO buffer.
+ * @return true if empty, false otherwise.
+ */
+bool FIFO_SPSC_IsEmpty(FIFO_SPSC_Buffer *fifo) {
+	return FIFO_SPSC_Count(fifo) == 0;
+}
+
+/**
+ * @brief Checks if the SPSC FIFO buffer is full.
+ * 
+ * @param fifo Pointer to the SPSC FIFO buffer.
+ * @return true if full, false otherwise.
+ */
+bool FIFO_SPSC_IsFull(FIFO_SPSC_Buffer *fifo) {
+	return FIFO_SPSC_Count(fifo) == fifo->size;
+}
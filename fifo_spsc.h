@@ -0,0 +1,89 @@
+#ifndef FIFO_SPSC_H_
+#define FIFO_SPSC_H_
+
+#include <stdatomic.h>
+#include "fifo_buffer.h"
+
+/**
+ * Define FIFO_SPSC_WAIT_ENABLED to 1 to build FIFO_SPSC_PopWait() and
+ * FIFO_SPSC_PushWait(). They sleep on a futex, so they are only available on Linux, and
+ * every publication of head or tail then pays for a full fence to check for a sleeper.
+ * With the default of 0 publication is a single release store.
+ */
+#ifndef FIFO_SPSC_WAIT_ENABLED
+#define FIFO_SPSC_WAIT_ENABLED 0
+#endif
+
+#if FIFO_SPSC_WAIT_ENABLED && !defined(__linux__)
+#error "FIFO_SPSC_WAIT_ENABLED requires Linux futexes"
+#endif
+
+#ifndef FIFO_CACHE_LINE_SIZE
+#define FIFO_CACHE_LINE_SIZE 64		///< Alignment used to keep producer and consumer state apart
+#endif
+
+/**
+ * Lock-free single-producer/single-consumer FIFO buffer.
+ * 
+ * Head and tail are free-running counters: the occupancy is `head - tail` and the
+ * position in the array is `counter & mask`, so there is no shared `count` that both
+ * sides write. The head is only written by the producer and the tail only by the
+ * consumer, and each sits on its own cache line.
+ * 
+ * Each side also keeps a private copy of the other side's counter next to its own. The
+ * producer only reloads the real tail when the buffer looks full against its copy, and
+ * the consumer only reloads the head when the buffer looks empty, so in steady state
+ * neither side touches the other's cache line on every operation.
+ * 
+ * Publication can be batched with FIFO_SPSC_SetBatch(): each side then works on a
+ * private counter and stores it to the shared one only every `batch` bytes, or when
+ * FIFO_SPSC_FlushPush() / FIFO_SPSC_FlushPop() is called, turning one release store and
+ * cache-line transfer per byte into one per batch. A side that finds the buffer full
+ * or empty publishes its pending bytes first, so batching can delay but never stall
+ * the other side.
+ * 
+ * With FIFO_SPSC_WAIT_ENABLED a side can also block with FIFO_SPSC_PopWait() /
+ * FIFO_SPSC_PushWait(). The sleeper announces itself in a waiter flag, and the other
+ * side only issues a wake-up system call when it sees that flag while publishing, so
+ * the non-blocking path never enters the kernel.
+ */
+typedef struct {
+	uint8_t *buffer;					///< Pointer to the circular buffer
+	fifo_index_t size;					///< Total size of the buffer, a power of two
+	fifo_index_t mask;					///< size - 1
+	fifo_index_t batch;					///< Bytes per publication of head or tail, 1 = every byte
+	_Alignas(FIFO_CACHE_LINE_SIZE)
+	_Atomic fifo_index_t head;			///< Published write counter, owned by the producer
+	fifo_index_t head_local;			///< Producer's write counter, including unpublished bytes
+	fifo_index_t tail_cache;			///< Producer's last observed tail
+	_Alignas(FIFO_CACHE_LINE_SIZE)
+	_Atomic fifo_index_t tail;			///< Published read counter, owned by the consumer
+	fifo_index_t tail_local;			///< Consumer's read counter, including unpublished bytes
+	fifo_index_t head_cache;			///< Consumer's last observed head
+#if FIFO_SPSC_WAIT_ENABLED
+	_Alignas(FIFO_CACHE_LINE_SIZE)
+	_Atomic uint32_t data_event;		///< Futex word bumped by the producer to wake the consumer
+	_Atomic uint32_t data_waiter;		///< Set while the consumer sleeps on data_event
+	_Atomic uint32_t space_event;		///< Futex word bumped by the consumer to wake the producer
+	_Atomic uint32_t space_waiter;		///< Set while the producer sleeps on space_event
+#endif
+} FIFO_SPSC_Buffer;
+
+
+bool FIFO_SPSC_Init(FIFO_SPSC_Buffer *fifo, uint8_t *buffer, fifo_index_t size);
+bool FIFO_SPSC_Init_Dynamic(FIFO_SPSC_Buffer *fifo, fifo_index_t size);
+void FIFO_SPSC_Free(FIFO_SPSC_Buffer *fifo);
+bool FIFO_SPSC_Push(FIFO_SPSC_Buffer *fifo, uint8_t data);
+bool FIFO_SPSC_Pop(FIFO_SPSC_Buffer *fifo, uint8_t *data);
+bool FIFO_SPSC_SetBatch(FIFO_SPSC_Buffer *fifo, fifo_index_t batch);
+void FIFO_SPSC_FlushPush(FIFO_SPSC_Buffer *fifo);
+void FIFO_SPSC_FlushPop(FIFO_SPSC_Buffer *fifo);
+#if FIFO_SPSC_WAIT_ENABLED
+bool FIFO_SPSC_PushWait(FIFO_SPSC_Buffer *fifo, uint8_t data, int32_t timeout_ms);
+bool FIFO_SPSC_PopWait(FIFO_SPSC_Buffer *fifo, uint8_t *data, int32_t timeout_ms);
+#endif
+fifo_index_t FIFO_SPSC_Count(FIFO_SPSC_Buffer *fifo);
+bool FIFO_SPSC_IsEmpty(FIFO_SPSC_Buffer *fifo);
+bool FIFO_SPSC_IsFull(FIFO_SPSC_Buffer *fifo);
+
+#endif /* FIFO_SPSC_H_ */
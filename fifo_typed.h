@@ -0,0 +1,112 @@
+#ifndef FIFO_TYPED_H_
+#define FIFO_TYPED_H_
+
+#include "fifo_buffer.h"
+
+/**
+ * Generates a FIFO that stores elements of `type` natively instead of as bytes.
+ * 
+ * FIFO_DEFINE_TYPED(ADC, uint16_t) defines the structure `ADC_FIFO` and the functions
+ * ADC_FIFO_Init(), ADC_FIFO_Reset(), ADC_FIFO_Push(), ADC_FIFO_PushOverwrite(),
+ * ADC_FIFO_Pop(), ADC_FIFO_Peek(), ADC_FIFO_IsEmpty(), ADC_FIFO_IsFull(),
+ * ADC_FIFO_SetOverwrite() and ADC_FIFO_CheckWatermarks(). They behave like their
+ * FIFO_Buffer counterparts, including overwrite mode and the 75%/25% default
+ * watermarks, but move one whole element per call with a single assignment.
+ * 
+ * The functions are `static inline`, so the macro can be used in a header shared by
+ * several translation units.
+ */
+#define FIFO_DEFINE_TYPED(name, type) \
+\
+typedef struct { \
+	type *buffer;					/* Pointer to the circular element array */ \
+	fifo_index_t size;				/* Total number of elements */ \
+	fifo_index_t head;				/* Write index */ \
+	fifo_index_t tail;				/* Read index */ \
+	fifo_index_t count;				/* Current number of elements */ \
+	fifo_index_t high_watermark;	/* High watermark threshold */ \
+	fifo_index_t low_watermark;		/* Low watermark threshold */ \
+	bool overwrite_enabled;			/* Enable overwrite when the FIFO is full */ \
+} name##_FIFO; \
+\
+static inline fifo_index_t name##_FIFO_Next(const name##_FIFO *fifo, fifo_index_t index) { \
+	index++; \
+	return (index == fifo->size) ? 0 : index; \
+} \
+\
+static inline void name##_FIFO_Init(name##_FIFO *fifo, type *buffer, fifo_index_t size) { \
+	fifo->buffer = buffer; \
+	fifo->size = size; \
+	fifo->head = 0; \
+	fifo->tail = 0; \
+	fifo->count = 0; \
+	fifo->high_watermark = size - (size / 4); \
+	fifo->low_watermark = size / 4; \
+	fifo->overwrite_enabled = false; \
+} \
+\
+static inline void name##_FIFO_Reset(name##_FIFO *fifo) { \
+	fifo->head = 0; \
+	fifo->tail = 0; \
+	fifo->count = 0; \
+} \
+\
+static inline void name##_FIFO_PushOverwrite(name##_FIFO *fifo, type data) { \
+	if (fifo->count == fifo->size) { \
+		fifo->tail = name##_FIFO_Next(fifo, fifo->tail); \
+	} else { \
+		fifo->count++; \
+	} \
+	fifo->buffer[fifo->head] = data; \
+	fifo->head = name##_FIFO_Next(fifo, fifo->head); \
+} \
+\
+static inline bool name##_FIFO_Push(name##_FIFO *fifo, type data) { \
+	if (fifo->count == fifo->size && !fifo->overwrite_enabled) { \
+		return false; \
+	} \
+	name##_FIFO_PushOverwrite(fifo, data); \
+	return true; \
+} \
+\
+static inline bool name##_FIFO_Pop(name##_FIFO *fifo, type *data) { \
+	if (fifo->count == 0) { \
+		return false; \
+	} \
+	*data = fifo->buffer[fifo->tail]; \
+	fifo->tail = name##_FIFO_Next(fifo, fifo->tail); \
+	fifo->count--; \
+	return true; \
+} \
+\
+static inline bool name##_FIFO_Peek(const name##_FIFO *fifo, fifo_index_t index, type *data) { \
+	if (index >= fifo->count) { \
+		return false; \
+	} \
+	fifo_index_t to_end = fifo->size - fifo->tail; \
+	*data = fifo->buffer[(index < to_end) ? fifo->tail + index : index - to_end]; \
+	return true; \
+} \
+\
+static inline bool name##_FIFO_IsEmpty(const name##_FIFO *fifo) { \
+	return fifo->count == 0; \
+} \
+\
+static inline bool name##_FIFO_IsFull(const name##_FIFO *fifo) { \
+	return fifo->count == fifo->size; \
+} \
+\
+static inline void name##_FIFO_SetOverwrite(name##_FIFO *fifo, bool enable) { \
+	fifo->overwrite_enabled = enable; \
+} \
+\
+static inline FIFO_WatermarkLevel name##_FIFO_CheckWatermarks(const name##_FIFO *fifo) { \
+	if (fifo->count >= fifo->high_watermark) { \
+		return FIFO_WATERMARK_HIGH; \
+	} else if (fifo->count <= fifo->low_watermark) { \
+		return FIFO_WATERMARK_LOW; \
+	} \
+	return FIFO_WATERMARK_NONE; \
+}
+
+#endif /* FIFO_TYPED_H_ */
@@ -0,0 +1,17 @@
+#ifndef TEST_COMMON_H_
+#define TEST_COMMON_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Stops the test with the failing condition and its line.
+ */
+#define TEST_CHECK(condition) do { \
+	if (!(condition)) { \
+		fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+		exit(1); \
+	} \
+} while (0)
+
+#endif /* TEST_COMMON_H_ */
@@ -0,0 +1,86 @@
+/*
+ * CRC kernel test for fifo_crc.c.
+ *
+ * Checks the published check values for "123456789" and compares FIFO_CRC16_Update()
+ * and FIFO_CRC32C_Update() with bit-at-a-time reference implementations on random
+ * data, lengths, alignments and splits into two segments, at every level
+ * FIFO_SIMD_SetLevel() accepts on this CPU (SSE4.2 and up use the crc32 instruction
+ * for CRC-32C). Build and run from the repository root once per table size:
+ *
+ *   gcc -std=c11 -O2 -pthread -I. tests/test_crc.c fifo_crc.c fifo_simd.c \
+ *       -o test_crc && ./test_crc
+ *
+ * adding -DFIFO_CRC_SLICES=1 for the byte-at-a-time tables. The program prints "ok" and
+ * exits with status 0 when every check passes.
+ */
+
+#include "fifo_crc.h"
+#include "fifo_simd.h"
+#include "test_common.h"
+#include <string.h>
+
+#define TEST_DATA_SIZE	1100	///< Random bytes the segments are taken from
+#define TEST_ROUNDS		3000	///< Random length, offset and split combinations per level
+
+/**
+ * @brief Bit-at-a-time CRC-16-CCITT, straight from the polynomial.
+ */
+static uint16_t Test_Crc16(const uint8_t *data, size_t length) {
+	uint16_t crc = FIFO_CRC16_INITIAL;
+	while (length-- > 0) {
+		crc ^= (uint16_t)(*data++ << 8);
+		for (int bit = 0; bit < 8; bit++) {
+			crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+		}
+	}
+	return crc;
+}
+
+/**
+ * @brief Bit-at-a-time CRC-32C, straight from the reflected polynomial.
+ */
+static uint32_t Test_Crc32c(const uint8_t *data, size_t length) {
+	uint32_t crc = FIFO_CRC32C_INITIAL;
+	while (length-- > 0) {
+		crc ^= *data++;
+		for (int bit = 0; bit < 8; bit++) {
+			crc = (crc & 1u) ? (crc >> 1) ^ 0x82F63B78u : crc >> 1;
+		}
+	}
+	return crc ^ 0xFFFFFFFFu;
+}
+
+int main(void) {
+	static const uint8_t check[] = "123456789";
+	static uint8_t data[TEST_DATA_SIZE];
+	FIFO_SIMD_Level supported = FIFO_SIMD_SetLevel(FIFO_SIMD_AVX2);
+
+	srand(1);
+	for (size_t i = 0; i < sizeof(data); i++) {
+		data[i] = (uint8_t)rand();
+	}
+
+	for (int level = FIFO_SIMD_SCALAR; level <= (int)supported; level++) {
+		TEST_CHECK(FIFO_SIMD_SetLevel((FIFO_SIMD_Level)level) == (FIFO_SIMD_Level)level);
+		TEST_CHECK(FIFO_CRC16_Update(FIFO_CRC16_INITIAL, check, 9) == 0x29B1u);
+		TEST_CHECK(FIFO_CRC32C_Final(FIFO_CRC32C_Update(FIFO_CRC32C_INITIAL, check, 9)) == 0xE3069283u);
+		TEST_CHECK(FIFO_CRC16_Update(FIFO_CRC16_INITIAL, check, 0) == FIFO_CRC16_INITIAL);
+
+		for (int round = 0; round < TEST_ROUNDS; round++) {
+			size_t offset = (size_t)rand() % 64;	// Every alignment
+			size_t length = (size_t)rand() % (TEST_DATA_SIZE - 64);
+			size_t split = (size_t)rand() % (length + 1);
+			const uint8_t *start = &data[offset];
+
+			uint16_t crc16 = FIFO_CRC16_Update(FIFO_CRC16_INITIAL, start, split);
+			crc16 = FIFO_CRC16_Update(crc16, start + split, length - split);
+			TEST_CHECK(crc16 == Test_Crc16(start, length));
+
+			uint32_t crc32c = FIFO_CRC32C_Update(FIFO_CRC32C_INITIAL, start, split);
+			crc32c = FIFO_CRC32C_Final(FIFO_CRC32C_Update(crc32c, start + split, length - split));
+			TEST_CHECK(crc32c == Test_Crc32c(start, length));
+		}
+	}
+	puts("ok");
+	return 0;
+}
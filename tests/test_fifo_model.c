@@ -0,0 +1,312 @@
+/*
+ * Randomized model test for FIFO_Buffer.
+ *
+ * Runs long random sequences of push, overwrite, pop, peek, block, reserve/commit,
+ * claim/release and reset operations on buffers of power-of-two and other sizes, and
+ * checks every result and the count against a plain reference queue after each step.
+ * With a 32-bit or wider index it also streams a 3 MiB buffer through several laps.
+ * It also checks that FIFO_Deinit() and FIFO_Free() are safe after a failed init and
+ * when called twice.
+ *
+ * Build and run from the repository root, once per index type:
+ *
+ *   gcc -std=c11 -O2 -pthread -I. tests/test_fifo_model.c fifo_buffer.c fifo_simd.c \
+ *       -o test_fifo_model && ./test_fifo_model
+ *
+ * adding -DFIFO_INDEX_TYPE=uint8_t, uint32_t or size_t for the other widths, and once
+ * more per width with -DFIFO_FREE_RUNNING=1, which also checks the counter wrap and the
+ * half-range size limit. The program prints "ok" and exits with status 0 when every
+ * check passes.
+ */
+
+#include "fifo_buffer.h"
+#include "test_common.h"
+#include <stdio.h>
+#include <string.h>
+
+#define MODEL_CAPACITY	256			///< Reference queue size, larger than every tested buffer
+#define MODEL_STEPS		200000		///< Random operations per buffer size
+
+static uint8_t model_data[MODEL_CAPACITY];	///< Reference queue contents
+static unsigned model_tail;					///< Index of the oldest byte in model_data
+static unsigned model_count;				///< Bytes in the reference queue
+static unsigned model_size;					///< Capacity of the buffer under test
+
+/**
+ * @brief Returns a byte of the reference queue.
+ *
+ * @param index Position from the oldest byte.
+ */
+static uint8_t Model_At(unsigned index) {
+	return model_data[(model_tail + index) % MODEL_CAPACITY];
+}
+
+/**
+ * @brief Appends a byte to the reference queue, dropping the oldest one when full.
+ */
+static void Model_Push(uint8_t value) {
+	if (model_count == model_size) {
+		model_tail = (model_tail + 1) % MODEL_CAPACITY;
+		model_count--;
+	}
+	model_data[(model_tail + model_count) % MODEL_CAPACITY] = value;
+	model_count++;
+}
+
+/**
+ * @brief Removes bytes from the front of the reference queue.
+ */
+static void Model_Drop(unsigned length) {
+	model_tail = (model_tail + length) % MODEL_CAPACITY;
+	model_count -= length;
+}
+
+/**
+ * @brief Runs random operations on one buffer and compares them with the reference queue.
+ *
+ * @param size Buffer size, at most MODEL_CAPACITY and representable in fifo_index_t.
+ */
+static void Test_Model(fifo_index_t size) {
+	static uint8_t storage[MODEL_CAPACITY];
+	uint8_t data[2 * MODEL_CAPACITY];
+	FIFO_Buffer fifo;
+
+	FIFO_Init(&fifo, storage, size);
+	model_tail = 0;
+	model_count = 0;
+	model_size = size;
+
+	const fifo_index_t max_index = (fifo_index_t)~(fifo_index_t)0;
+	unsigned max_length = (size > max_index / 2) ? (unsigned)max_index : 2u * size + 1;	// Past the size to exercise clamping
+
+	for (unsigned step = 0; step < MODEL_STEPS; step++) {
+		unsigned length = (unsigned)rand() % (max_length + 1);
+		uint8_t value = (uint8_t)rand();
+
+		switch (rand() % 10) {
+		case 0: {	// Single push, rejected or overwriting when full
+			bool full = model_count == size;
+			bool pushed = FIFO_Push(&fifo, value);
+			TEST_CHECK(pushed == (!full || fifo.overwrite_enabled));
+			if (pushed) {
+				Model_Push(value);
+			}
+			break;
+		}
+		case 1:		// Forced overwrite
+			FIFO_PushOverwrite(&fifo, value);
+			Model_Push(value);
+			break;
+		case 2: {	// Single pop
+			bool popped = FIFO_Pop(&fifo, &value);
+			TEST_CHECK(popped == (model_count > 0));
+			if (popped) {
+				TEST_CHECK(value == Model_At(0));
+				Model_Drop(1);
+			}
+			break;
+		}
+		case 3: {	// Block push
+			for (unsigned i = 0; i < length; i++) {
+				data[i] = (uint8_t)rand();
+			}
+			unsigned space = size - model_count;
+			unsigned expected = (fifo.overwrite_enabled || length <= space) ? length : space;
+			TEST_CHECK(FIFO_PushBlock(&fifo, data, (fifo_index_t)length) == expected);
+			for (unsigned i = 0; i < expected; i++) {
+				Model_Push(data[i]);
+			}
+			break;
+		}
+		case 4: {	// Block pop
+			unsigned expected = (length < model_count) ? length : model_count;
+			TEST_CHECK(FIFO_PopBlock(&fifo, data, (fifo_index_t)length) == expected);
+			for (unsigned i = 0; i < expected; i++) {
+				TEST_CHECK(data[i] == Model_At(i));
+			}
+			Model_Drop(expected);
+			break;
+		}
+		case 5: {	// Peeks at any index, including past the end
+			unsigned index = (unsigned)rand() % (model_count + 2);
+			unsigned expected = (index >= model_count) ? 0 : model_count - index;
+			if (expected > length) {
+				expected = length;
+			}
+			TEST_CHECK(FIFO_PeekBlock(&fifo, (fifo_index_t)index, data, (fifo_index_t)length) == expected);
+			for (unsigned i = 0; i < expected; i++) {
+				TEST_CHECK(data[i] == Model_At(index + i));
+			}
+			TEST_CHECK(FIFO_Peek(&fifo, (fifo_index_t)index, &value) == (index < model_count));
+			if (index < model_count) {
+				TEST_CHECK(value == Model_At(index));
+			}
+			break;
+		}
+		case 6: {	// Zero-copy write
+			fifo_index_t granted = (fifo_index_t)length;
+			uint8_t *span = FIFO_WriteReserve(&fifo, &granted);
+			TEST_CHECK(granted <= length && granted <= size - model_count);
+			TEST_CHECK((span != NULL) == (granted > 0));
+			for (fifo_index_t i = 0; i < granted; i++) {
+				span[i] = (uint8_t)rand();
+				Model_Push(span[i]);
+			}
+			TEST_CHECK(FIFO_WriteCommit(&fifo, granted));
+			break;
+		}
+		case 7: {	// Zero-copy read
+			fifo_index_t granted = (fifo_index_t)length;
+			const uint8_t *span = FIFO_ReadClaim(&fifo, &granted);
+			TEST_CHECK(granted <= length && granted <= model_count);
+			TEST_CHECK((span != NULL) == (granted > 0));
+			for (fifo_index_t i = 0; i < granted; i++) {
+				TEST_CHECK(span[i] == Model_At(i));
+			}
+			TEST_CHECK(FIFO_ReadRelease(&fifo, granted));
+			Model_Drop(granted);
+			TEST_CHECK(!FIFO_ReadRelease(&fifo, (fifo_index_t)(model_count + 1)));
+			break;
+		}
+		case 8:
+			FIFO_SetOverwrite(&fifo, rand() % 2);
+			break;
+		default:
+			if (rand() % 64 == 0) {
+				FIFO_Reset(&fifo);
+				Model_Drop(model_count);
+			}
+			break;
+		}
+
+		TEST_CHECK(FIFO_Count(&fifo) == model_count);
+		TEST_CHECK(FIFO_IsEmpty(&fifo) == (model_count == 0));
+		TEST_CHECK(FIFO_IsFull(&fifo) == (model_count == size));
+	}
+	FIFO_Deinit(&fifo);
+}
+
+/**
+ * @brief Streams several laps through a 3 MiB buffer with block copies.
+ *
+ * Only run when fifo_index_t can hold the size.
+ */
+static void Test_LargeBuffer(void) {
+	const fifo_index_t size = (fifo_index_t)(3ul * 1024 * 1024);
+	const fifo_index_t chunk_length = (fifo_index_t)4093;	// Not a divisor of the size, so copies straddle the wrap point
+	static uint8_t chunk[4093];
+	FIFO_Buffer fifo;
+	uint32_t written = 0, read = 0;
+
+	TEST_CHECK(FIFO_Init_Dynamic(&fifo, size));
+	while (read < 4 * size) {
+		while (size - FIFO_Count(&fifo) >= chunk_length) {
+			for (fifo_index_t i = 0; i < chunk_length; i++) {
+				chunk[i] = (uint8_t)(written++ * 7);
+			}
+			TEST_CHECK(FIFO_PushBlock(&fifo, chunk, chunk_length) == chunk_length);
+		}
+		TEST_CHECK(FIFO_IsFull(&fifo) == (FIFO_Count(&fifo) == size));
+		fifo_index_t length = FIFO_PopBlock(&fifo, chunk, chunk_length);
+		TEST_CHECK(length == chunk_length);
+		for (fifo_index_t i = 0; i < length; i++) {
+			TEST_CHECK(chunk[i] == (uint8_t)(read++ * 7));
+		}
+	}
+	FIFO_Free(&fifo);
+}
+
+#if FIFO_FREE_RUNNING
+/**
+ * Starts the counters just below the top of the index range and streams bytes through
+ * power-of-two and other sizes, so head and tail wrap while the buffer holds data.
+ * Also checks that a size above half the index range is rejected unless it is a power
+ * of two.
+ */
+static void Test_FreeRunning(void) {
+	static const unsigned sizes[] = { 3, 8, 100, 128 };
+	const fifo_index_t max_index = (fifo_index_t)~(fifo_index_t)0;
+	static uint8_t storage[128];
+	FIFO_Buffer fifo;
+
+	for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+		fifo_index_t size = (fifo_index_t)sizes[i];
+		uint8_t written = 0, read = 0, value;
+
+		FIFO_Init(&fifo, storage, size);
+		if ((size & (size - 1)) == 0) {
+			fifo.head = fifo.tail = (fifo_index_t)(max_index - 2);	// Wraps with the index type
+		}
+		else {
+			fifo.head = fifo.tail = (fifo_index_t)(2 * size - 2);	// Wraps modulo 2 * size
+		}
+		for (unsigned step = 0; step < 4 * sizes[i] + 10; step++) {
+			while (!FIFO_IsFull(&fifo)) {
+				TEST_CHECK(FIFO_Push(&fifo, written++));
+			}
+			TEST_CHECK(FIFO_Count(&fifo) == size);
+			TEST_CHECK(!FIFO_Push(&fifo, 0));
+			TEST_CHECK(FIFO_Pop(&fifo, &value) && value == read++);
+			TEST_CHECK(FIFO_Count(&fifo) == size - 1);
+		}
+		while (FIFO_Pop(&fifo, &value)) {
+			TEST_CHECK(value == read++);
+		}
+		TEST_CHECK(read == written && FIFO_IsEmpty(&fifo));
+		FIFO_Deinit(&fifo);
+	}
+
+	FIFO_Buffer large;
+	TEST_CHECK(!FIFO_Init_Dynamic(&large, (fifo_index_t)((max_index >> 1) + 2)));
+	TEST_CHECK(large.buffer == NULL);	// Safe to pass to FIFO_Free()
+}
+#endif
+
+/**
+ * Releases buffers after failed and successful inits, twice each, starting from a
+ * structure filled with garbage as it would be on the stack.
+ */
+static void Test_Lifecycle(void) {
+	static uint8_t storage[64];
+	FIFO_Buffer fifo;
+
+	memset(&fifo, 0x41, sizeof(fifo));
+	TEST_CHECK(!FIFO_Init_Dynamic(&fifo, 0));
+	TEST_CHECK(fifo.buffer == NULL);
+	FIFO_Free(&fifo);
+	FIFO_Deinit(&fifo);
+
+	memset(&fifo, 0x41, sizeof(fifo));
+	TEST_CHECK(!FIFO_Init_Pow2(&fifo, storage, 48));
+	FIFO_Deinit(&fifo);
+
+	FIFO_Init(&fifo, storage, sizeof(storage));
+	TEST_CHECK(FIFO_Push(&fifo, 1));
+	FIFO_Deinit(&fifo);
+	TEST_CHECK(fifo.buffer == NULL);
+	FIFO_Deinit(&fifo);
+
+	TEST_CHECK(FIFO_Init_Dynamic(&fifo, 100));
+	TEST_CHECK(FIFO_Push(&fifo, 1));
+	FIFO_Free(&fifo);
+	TEST_CHECK(fifo.buffer == NULL);
+	FIFO_Free(&fifo);
+}
+
+int main(void) {
+	static const unsigned sizes[] = { 1, 2, 3, 7, 8, 48, 64, 100, 128 };
+
+	Test_Lifecycle();
+	srand(1);
+	for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+		Test_Model((fifo_index_t)sizes[i]);
+	}
+	if ((fifo_index_t)~(fifo_index_t)0 >= 3ul * 1024 * 1024) {
+		Test_LargeBuffer();
+	}
+#if FIFO_FREE_RUNNING
+	Test_FreeRunning();
+#endif
+	puts("ok");
+	return 0;
+}
@@ -0,0 +1,117 @@
+/*
+ * Multi-producer/multi-consumer stress test for FIFO_MPMC_Queue.
+ *
+ * Three producer threads push 24-byte elements carrying their producer number, a
+ * sequence number and a checksum, while three consumer threads pop them. Each consumer
+ * checks that every producer's sequence numbers only increase and that elements arrive
+ * intact; at the end every element must have been popped exactly once. 300k elements
+ * through 64 cells wrap 16-bit counters several times. Build and run from the
+ * repository root, and again with -fsanitize=thread to check the memory ordering:
+ *
+ *   gcc -std=c11 -O2 -pthread -I. tests/test_mpmc.c fifo_buffer.c fifo_simd.c fifo_mpmc.c \
+ *       -o test_mpmc && ./test_mpmc
+ *
+ * The program prints "ok" and exits with status 0 when every check passes.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "fifo_mpmc.h"
+#include "test_common.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+
+#define PRODUCERS			3			///< Producer threads
+#define CONSUMERS			3			///< Consumer threads
+#define PRODUCER_ELEMENTS	100000ul	///< Elements pushed by each producer
+#define QUEUE_CELLS			64			///< Queue size
+
+/**
+ * Element moved through the queue, 24 bytes.
+ */
+typedef struct {
+	uint32_t producer;					///< Producer number
+	uint32_t check;						///< Derived from the other fields, detects torn copies
+	uint64_t sequence;					///< Position in the producer's stream
+	uint64_t payload;					///< Filler derived from the sequence
+} Test_Element;
+
+static FIFO_MPMC_Queue mpmc;				///< Queue shared by all threads
+static _Atomic unsigned long popped;		///< Elements popped by all consumers
+static _Atomic unsigned long long sequence_sum;	///< Sum of all popped sequence numbers
+
+/**
+ * @brief Check value of an element.
+ */
+static uint32_t Test_Check(const Test_Element *element) {
+	return (uint32_t)(element->sequence * 2654435761u) ^ element->producer ^ (uint32_t)(element->payload >> 7);
+}
+
+/**
+ * @brief Producer thread: pushes its whole stream, yielding while the queue is full.
+ *
+ * @param arg Producer number.
+ */
+static void *Test_Producer(void *arg) {
+	Test_Element element = { .producer = (uint32_t)(uintptr_t)arg };
+	for (unsigned long i = 0; i < PRODUCER_ELEMENTS; i++) {
+		element.sequence = i;
+		element.payload = i * 0x9E3779B97F4A7C15ull;
+		element.check = Test_Check(&element);
+		while (!FIFO_MPMC_Push(&mpmc, &element)) {
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief Consumer thread: pops until all elements are consumed, checking each one.
+ */
+static void *Test_Consumer(void *arg) {
+	unsigned long long next[PRODUCERS] = { 0 };	// Lowest sequence still allowed per producer
+	Test_Element element;
+	(void)arg;
+
+	while (atomic_load(&popped) < PRODUCERS * PRODUCER_ELEMENTS) {
+		if (!FIFO_MPMC_Pop(&mpmc, &element)) {
+			sched_yield();
+			continue;
+		}
+		TEST_CHECK(element.producer < PRODUCERS);
+		TEST_CHECK(element.check == Test_Check(&element));
+		TEST_CHECK(element.sequence >= next[element.producer]);
+		next[element.producer] = element.sequence + 1;
+		atomic_fetch_add(&sequence_sum, element.sequence);
+		atomic_fetch_add(&popped, 1);
+	}
+	return NULL;
+}
+
+int main(void) {
+	const fifo_index_t max_index = (fifo_index_t)~(fifo_index_t)0;
+	pthread_t threads[PRODUCERS + CONSUMERS];
+	Test_Element element;
+
+	TEST_CHECK(!FIFO_MPMC_Init_Dynamic(&mpmc, 48, sizeof(Test_Element)));	// Not a power of two
+	TEST_CHECK(!FIFO_MPMC_Init_Dynamic(&mpmc, (fifo_index_t)((max_index >> 1) + 1), sizeof(Test_Element)));
+
+	TEST_CHECK(FIFO_MPMC_Init_Dynamic(&mpmc, QUEUE_CELLS, sizeof(Test_Element)));
+	for (uintptr_t p = 0; p < PRODUCERS; p++) {
+		TEST_CHECK(pthread_create(&threads[p], NULL, Test_Producer, (void *)p) == 0);
+	}
+	for (unsigned c = 0; c < CONSUMERS; c++) {
+		TEST_CHECK(pthread_create(&threads[PRODUCERS + c], NULL, Test_Consumer, NULL) == 0);
+	}
+	for (unsigned t = 0; t < PRODUCERS + CONSUMERS; t++) {
+		TEST_CHECK(pthread_join(threads[t], NULL) == 0);
+	}
+
+	TEST_CHECK(atomic_load(&popped) == PRODUCERS * PRODUCER_ELEMENTS);
+	TEST_CHECK(atomic_load(&sequence_sum) == PRODUCERS * (PRODUCER_ELEMENTS * (PRODUCER_ELEMENTS - 1) / 2));
+	TEST_CHECK(FIFO_MPMC_IsEmpty(&mpmc) && !FIFO_MPMC_Pop(&mpmc, &element));
+	FIFO_MPMC_Free(&mpmc);
+	puts("ok");
+	return 0;
+}
@@ -0,0 +1,73 @@
+/*
+ * Multi-producer stress test for FIFO_MPSC_Buffer.
+ *
+ * Four producer threads push tagged byte sequences into a small buffer while the main
+ * thread pops them, checking that each producer's bytes arrive complete and in order.
+ * Build and run from the repository root, also with -DFIFO_INDEX_TYPE=uint8_t so the
+ * counters wrap often, and with -fsanitize=thread to check the memory ordering:
+ *
+ *   gcc -std=c11 -O2 -pthread -I. tests/test_mpsc.c fifo_buffer.c fifo_simd.c fifo_mpsc.c \
+ *       -o test_mpsc && ./test_mpsc
+ *
+ * The program prints "ok" and exits with status 0 when every check passes.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "fifo_mpsc.h"
+#include "test_common.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+
+#define PRODUCERS			4			///< Producer threads, tagged in the top two bits of each byte
+#define PRODUCER_BYTES		200000ul	///< Bytes pushed by each producer
+#define BUFFER_SLOTS		32			///< Fits the quarter-range limit of an 8-bit index
+
+static FIFO_MPSC_Buffer mpsc;	///< Buffer shared by all threads
+
+/**
+ * @brief Producer thread: pushes its tag and a 6-bit sequence number, yielding when full.
+ *
+ * @param arg Producer number, 0 to PRODUCERS - 1.
+ */
+static void *Test_Producer(void *arg) {
+	uint8_t tag = (uint8_t)((uintptr_t)arg << 6);
+	for (unsigned long i = 0; i < PRODUCER_BYTES; i++) {
+		while (!FIFO_MPSC_Push(&mpsc, (uint8_t)(tag | (i & 63)))) {
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+int main(void) {
+	const fifo_index_t max_index = (fifo_index_t)~(fifo_index_t)0;
+	pthread_t producers[PRODUCERS];
+	unsigned long next[PRODUCERS] = { 0 };
+	uint8_t value;
+
+	TEST_CHECK(!FIFO_MPSC_Init_Dynamic(&mpsc, 48));	// Not a power of two
+	TEST_CHECK(!FIFO_MPSC_Init_Dynamic(&mpsc, (fifo_index_t)((max_index >> 1) + 1)));	// Over a quarter of the range
+
+	TEST_CHECK(FIFO_MPSC_Init_Dynamic(&mpsc, BUFFER_SLOTS));
+	for (uintptr_t p = 0; p < PRODUCERS; p++) {
+		TEST_CHECK(pthread_create(&producers[p], NULL, Test_Producer, (void *)p) == 0);
+	}
+	for (unsigned long i = 0; i < PRODUCERS * PRODUCER_BYTES; i++) {
+		while (!FIFO_MPSC_Pop(&mpsc, &value)) {
+			sched_yield();
+		}
+		unsigned producer = value >> 6;
+		TEST_CHECK((value & 63) == (next[producer] & 63));
+		next[producer]++;
+	}
+	for (unsigned p = 0; p < PRODUCERS; p++) {
+		TEST_CHECK(pthread_join(producers[p], NULL) == 0);
+		TEST_CHECK(next[p] == PRODUCER_BYTES);
+	}
+	TEST_CHECK(FIFO_MPSC_IsEmpty(&mpsc) && FIFO_MPSC_Count(&mpsc) == 0);
+	FIFO_MPSC_Free(&mpsc);
+	puts("ok");
+	return 0;
+}
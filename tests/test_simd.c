@@ -0,0 +1,163 @@
+/*
+ * SIMD kernel and ring search test.
+ *
+ * At every level FIFO_SIMD_SetLevel() accepts on this CPU, compares FIFO_SIMD_FindByte()
+ * and FIFO_SIMD_Xor() with plain loops for every start alignment and lengths that are
+ * not multiples of the 16/32/64-byte vector steps, and checks FIFO_FindByte() and
+ * FIFO_FindPattern() on a ring buffer for matches before, at and across the wrap point.
+ * Build and run from the repository root:
+ *
+ *   gcc -std=c11 -O2 -pthread -I. tests/test_simd.c fifo_buffer.c fifo_simd.c \
+ *       -o test_simd && ./test_simd
+ *
+ * The program prints "ok" and exits with status 0 when every check passes.
+ */
+
+#include "fifo_buffer.h"
+#include "fifo_simd.h"
+#include "test_common.h"
+#include <string.h>
+
+#define TEST_MAX_LENGTH		300		///< Longest array given to the kernels
+#define TEST_MAX_OFFSET		64		///< Start offsets tried, covering every alignment up to AVX2 width
+
+/**
+ * @brief Reference version of FIFO_SIMD_FindByte().
+ */
+static size_t Test_FindByte(const uint8_t *data, size_t length, uint8_t value) {
+	for (size_t i = 0; i < length; i++) {
+		if (data[i] == value) {
+			return i;
+		}
+	}
+	return length;
+}
+
+/**
+ * @brief Reference version of FIFO_SIMD_Xor().
+ */
+static uint8_t Test_Xor(const uint8_t *data, size_t length) {
+	uint8_t result = 0;
+	for (size_t i = 0; i < length; i++) {
+		result ^= data[i];
+	}
+	return result;
+}
+
+/**
+ * Every offset and length up to the limits, with the searched byte absent, at the
+ * first and last position and at a position inside the last partial vector.
+ */
+static void Test_Kernels(void) {
+	static uint8_t data[TEST_MAX_OFFSET + TEST_MAX_LENGTH];
+
+	for (size_t i = 0; i < sizeof(data); i++) {
+		data[i] = (uint8_t)(i * 7 + 1) | 0x01;	// Odd bytes only, so even values are absent
+	}
+	for (size_t offset = 0; offset < TEST_MAX_OFFSET; offset++) {
+		for (size_t length = 0; length <= TEST_MAX_LENGTH; length++) {
+			const uint8_t *start = &data[offset];
+			TEST_CHECK(FIFO_SIMD_Xor(start, length) == Test_Xor(start, length));
+			TEST_CHECK(FIFO_SIMD_FindByte(start, length, 0x00) == length);
+			if (length == 0) {
+				continue;
+			}
+			TEST_CHECK(FIFO_SIMD_FindByte(start, length, start[0]) == 0);
+			TEST_CHECK(FIFO_SIMD_FindByte(start, length, start[length - 1]) == Test_FindByte(start, length, start[length - 1]));
+
+			size_t position = (length * 7 / 11) % length;	// Moves through the vectors as the length grows
+			uint8_t saved = data[offset + position];
+			data[offset + position] = 0x42;
+			TEST_CHECK(FIFO_SIMD_FindByte(start, length, 0x42) == position);
+			TEST_CHECK(FIFO_SIMD_Xor(start, length) == Test_Xor(start, length));
+			data[offset + position] = saved;
+		}
+	}
+}
+
+/**
+ * FIFO_FindByte() on a ring whose stored bytes wrap around the end of the array.
+ */
+static void Test_RingFind(void) {
+	static uint8_t storage[200];
+	FIFO_Buffer fifo;
+
+	for (fifo_index_t tail = 0; tail < sizeof(storage); tail += 13) {
+		FIFO_Init(&fifo, storage, sizeof(storage));
+		FIFO_WriteCommit(&fifo, tail);	// Move head and tail to `tail` without copying
+		FIFO_ReadRelease(&fifo, tail);
+		for (fifo_index_t i = 0; i < 150; i++) {
+			TEST_CHECK(FIFO_Push(&fifo, (uint8_t)(2 * i + 1)));	// Odd bytes only
+		}
+		TEST_CHECK(FIFO_FindByte(&fifo, 0, 0x00) == 150);
+		for (fifo_index_t match = 0; match < 150; match++) {
+			uint8_t value = (uint8_t)(2 * match + 1);	// Unique among the first 128 bytes
+			fifo_index_t expected = (match < 128) ? match : (fifo_index_t)(match - 128);
+			TEST_CHECK(FIFO_FindByte(&fifo, 0, value) == expected);
+			TEST_CHECK(FIFO_FindByte(&fifo, match, value) == match);
+			TEST_CHECK(FIFO_FindByte(&fifo, (fifo_index_t)(match + 1), value) == ((match < 22) ? match + 128 : 150));
+		}
+		TEST_CHECK(FIFO_FindByte(&fifo, 150, 0x01) == 150);	// Start at the count
+		FIFO_Deinit(&fifo);
+	}
+}
+
+/**
+ * @brief Reference search over a linear copy of the stored bytes.
+ */
+static fifo_index_t Test_FindPattern(const uint8_t *data, fifo_index_t count, fifo_index_t index,
+	const uint8_t *pattern, fifo_index_t length) {
+	for (fifo_index_t i = index; length <= count && i <= count - length; i++) {
+		if (memcmp(&data[i], pattern, length) == 0) {
+			return i;
+		}
+	}
+	return count;
+}
+
+/**
+ * FIFO_FindPattern() on rings holding false starts and a delimiter placed at every
+ * position around the wrap point, so matches straddle the end of the array by every
+ * possible split.
+ */
+static void Test_RingPattern(void) {
+	static const uint8_t pattern[] = { '\r', '\n', '\r', '\n', 0x7E };
+	static uint8_t storage[96];
+	uint8_t linear[96];
+	FIFO_Buffer fifo;
+	const fifo_index_t count = 80;
+	const fifo_index_t tail = 50;	// Stored bytes wrap after index 45
+
+	for (fifo_index_t length = 1; length <= sizeof(pattern); length++) {
+		for (fifo_index_t place = 30; place < 60 && place + length <= count; place++) {
+			for (fifo_index_t i = 0; i < count; i++) {
+				linear[i] = (uint8_t)(i % 3 == 0 ? '\r' : 'a' + i % 26);	// False starts, no '\n'
+			}
+			memcpy(&linear[place], pattern, length);
+
+			FIFO_Init(&fifo, storage, sizeof(storage));
+			FIFO_WriteCommit(&fifo, tail);
+			FIFO_ReadRelease(&fifo, tail);
+			TEST_CHECK(FIFO_PushBlock(&fifo, linear, count) == count);
+			for (fifo_index_t index = 0; index <= count; index += 7) {
+				TEST_CHECK(FIFO_FindPattern(&fifo, index, pattern, length) ==
+					Test_FindPattern(linear, count, index, pattern, length));
+			}
+			TEST_CHECK(FIFO_FindPattern(&fifo, 0, pattern, 0) == count);
+			FIFO_Deinit(&fifo);
+		}
+	}
+}
+
+int main(void) {
+	FIFO_SIMD_Level supported = FIFO_SIMD_SetLevel(FIFO_SIMD_AVX2);
+
+	for (int level = FIFO_SIMD_SCALAR; level <= (int)supported; level++) {
+		TEST_CHECK(FIFO_SIMD_SetLevel((FIFO_SIMD_Level)level) == (FIFO_SIMD_Level)level);
+		Test_Kernels();
+		Test_RingFind();
+		Test_RingPattern();
+	}
+	puts("ok");
+	return 0;
+}
@@ -0,0 +1,104 @@
+/*
+ * Two-thread stress test for FIFO_SPSC_Buffer.
+ *
+ * A producer thread pushes a known byte sequence while the main thread pops and checks
+ * it, so lost, duplicated or reordered bytes are detected. Small buffers keep each side
+ * running into the other, so the cached opposite index is reloaded often, and batched
+ * runs check that every byte arrives once the producer flushes. Build and run
+ * from the repository root, and again with -fsanitize=thread to check the memory
+ * ordering:
+ *
+ *   gcc -std=c11 -O2 -pthread -I. tests/test_spsc.c fifo_buffer.c fifo_simd.c fifo_spsc.c \
+ *       -o test_spsc && ./test_spsc
+ *
+ * The program prints "ok" and exits with status 0 when every check passes.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "fifo_spsc.h"
+#include "test_common.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+
+#define STREAM_BYTES	2000000ul	///< Bytes moved through the buffer per run
+#define FLUSH_INTERVAL	1000ul		///< Bytes between explicit producer flushes
+
+static FIFO_SPSC_Buffer spsc;	///< Buffer shared by the producer thread and the main thread
+
+/**
+ * @brief Byte expected at a position of the stream.
+ */
+static uint8_t Stream_Byte(unsigned long position) {
+	return (uint8_t)(position * 31 + (position >> 8));
+}
+
+/**
+ * @brief Producer thread: pushes the whole stream, yielding while the buffer is full.
+ *
+ * Flushes every FLUSH_INTERVAL bytes and at the end, so a batched consumer also sees
+ * the last partial batch.
+ */
+static void *Test_Producer(void *arg) {
+	(void)arg;
+	for (unsigned long i = 0; i < STREAM_BYTES; i++) {
+		while (!FIFO_SPSC_Push(&spsc, Stream_Byte(i))) {
+			sched_yield();
+		}
+		if (i % FLUSH_INTERVAL == FLUSH_INTERVAL - 1) {
+			FIFO_SPSC_FlushPush(&spsc);
+		}
+	}
+	FIFO_SPSC_FlushPush(&spsc);
+	return NULL;
+}
+
+/**
+ * @brief Moves the stream through a buffer of the given size and checks every byte.
+ *
+ * @param size Buffer size, a power of two.
+ * @param batch Bytes per publication on both sides, see FIFO_SPSC_SetBatch().
+ */
+static void Test_Stream(fifo_index_t size, fifo_index_t batch) {
+	pthread_t producer;
+	uint8_t value;
+
+	TEST_CHECK(FIFO_SPSC_Init_Dynamic(&spsc, size));
+	TEST_CHECK(FIFO_SPSC_SetBatch(&spsc, batch));
+	TEST_CHECK(pthread_create(&producer, NULL, Test_Producer, NULL) == 0);
+	for (unsigned long i = 0; i < STREAM_BYTES; i++) {
+		while (!FIFO_SPSC_Pop(&spsc, &value)) {
+			sched_yield();
+		}
+		TEST_CHECK(value == Stream_Byte(i));
+	}
+	TEST_CHECK(pthread_join(producer, NULL) == 0);
+	FIFO_SPSC_FlushPop(&spsc);
+	TEST_CHECK(FIFO_SPSC_IsEmpty(&spsc));
+	TEST_CHECK(!FIFO_SPSC_Pop(&spsc, &value));
+	FIFO_SPSC_Free(&spsc);
+}
+
+int main(void) {
+	static uint8_t storage[96];
+
+	TEST_CHECK(!FIFO_SPSC_Init(&spsc, storage, 96));	// Not a power of two
+	TEST_CHECK(FIFO_SPSC_Init(&spsc, storage, 64));
+	for (unsigned i = 0; i < 64; i++) {
+		TEST_CHECK(FIFO_SPSC_Push(&spsc, (uint8_t)i));
+	}
+	TEST_CHECK(FIFO_SPSC_IsFull(&spsc) && FIFO_SPSC_Count(&spsc) == 64);
+	TEST_CHECK(!FIFO_SPSC_Push(&spsc, 0));
+
+	TEST_CHECK(!FIFO_SPSC_SetBatch(&spsc, 0));
+	TEST_CHECK(!FIFO_SPSC_SetBatch(&spsc, 128));	// Larger than the buffer
+
+	Test_Stream(4, 1);
+	Test_Stream(16, 1);
+	Test_Stream(1024, 1);
+	Test_Stream(256, 8);
+	Test_Stream(256, 64);
+	puts("ok");
+	return 0;
+}
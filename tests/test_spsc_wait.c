@@ -0,0 +1,68 @@
+/*
+ * Blocking push/pop test for FIFO_SPSC_Buffer.
+ *
+ * A producer thread pushes a known byte sequence with FIFO_SPSC_PushWait() through a
+ * small buffer while the main thread takes it with FIFO_SPSC_PopWait(), so both sides
+ * sleep and wake each other many times. It also checks that the waits time out on an
+ * empty and on a full buffer. Linux only; build and run from the repository root:
+ *
+ *   gcc -std=c11 -O2 -pthread -I. -DFIFO_SPSC_WAIT_ENABLED=1 tests/test_spsc_wait.c \
+ *       fifo_buffer.c fifo_simd.c fifo_spsc.c -o test_spsc_wait && ./test_spsc_wait
+ *
+ * The program prints "ok" and exits with status 0 when every check passes.
+ */
+
+#include "fifo_spsc.h"
+#include "test_common.h"
+#include <pthread.h>
+#include <stdio.h>
+
+#if !FIFO_SPSC_WAIT_ENABLED
+#error "Build this test with -DFIFO_SPSC_WAIT_ENABLED=1"
+#endif
+
+#define STREAM_BYTES	300000ul	///< Bytes moved through the buffer
+
+static FIFO_SPSC_Buffer spsc;	///< Buffer shared by the producer thread and the main thread
+
+/**
+ * @brief Byte expected at a position of the stream.
+ */
+static uint8_t Stream_Byte(unsigned long position) {
+	return (uint8_t)(position * 31 + (position >> 8));
+}
+
+/**
+ * @brief Producer thread: pushes the whole stream, sleeping while the buffer is full.
+ */
+static void *Test_Producer(void *arg) {
+	(void)arg;
+	for (unsigned long i = 0; i < STREAM_BYTES; i++) {
+		TEST_CHECK(FIFO_SPSC_PushWait(&spsc, Stream_Byte(i), -1));
+	}
+	return NULL;
+}
+
+int main(void) {
+	pthread_t producer;
+	uint8_t value;
+
+	TEST_CHECK(FIFO_SPSC_Init_Dynamic(&spsc, 64));
+	TEST_CHECK(!FIFO_SPSC_PopWait(&spsc, &value, 20));	// Empty: times out
+
+	TEST_CHECK(pthread_create(&producer, NULL, Test_Producer, NULL) == 0);
+	for (unsigned long i = 0; i < STREAM_BYTES; i++) {
+		TEST_CHECK(FIFO_SPSC_PopWait(&spsc, &value, -1));
+		TEST_CHECK(value == Stream_Byte(i));
+	}
+	TEST_CHECK(pthread_join(producer, NULL) == 0);
+	TEST_CHECK(FIFO_SPSC_IsEmpty(&spsc));
+
+	for (unsigned i = 0; i < 64; i++) {
+		TEST_CHECK(FIFO_SPSC_PushWait(&spsc, (uint8_t)i, 0));
+	}
+	TEST_CHECK(!FIFO_SPSC_PushWait(&spsc, 0, 20));		// Full: times out
+	FIFO_SPSC_Free(&spsc);
+	puts("ok");
+	return 0;
+}
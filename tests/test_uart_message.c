@@ -0,0 +1,255 @@
+/*
+ * Frame parser test for uart_message_fifo.c.
+ *
+ * Feeds sealed frames, line noise, partial frames, impossible lengths and corrupted
+ * frames into a FIFO_Buffer and checks what Get_UART_Message() returns and counts, also
+ * for frames that straddle the wrap point. Also checks zero-copy views of wrapped
+ * frames and that Release_UART_Message() rejects stale, repeated and foreign views. Build and run from the repository root once
+ * per integrity check:
+ *
+ *   gcc -std=c11 -O2 -pthread -I. tests/test_uart_message.c fifo_buffer.c fifo_simd.c \
+ *       fifo_crc.c uart_message_fifo.c -o test_uart_message && ./test_uart_message
+ *
+ * adding -DUART_MESSAGE_INTEGRITY=UART_INTEGRITY_CRC16 or UART_INTEGRITY_CRC32C for the
+ * CRC variants. The program prints "ok" and exits with status 0 when every check passes.
+ */
+
+#include "uart_message_fifo.h"
+#include "test_common.h"
+#include <string.h>
+
+/**
+ * @brief Writes a payload derived from `seed` and seals the frame.
+ */
+static void Test_BuildFrame(uint8_t *frame, uint8_t length, uint8_t seed) {
+	for (uint8_t i = 2; i < length; i++) {
+		frame[i] = (uint8_t)(seed + i * 13);
+	}
+	TEST_CHECK(Seal_UART_Message(frame, length));
+}
+
+/**
+ * @brief Checks that the next message is exactly `expected`.
+ */
+static void Test_Expect(FIFO_Buffer *fifo, const uint8_t *expected, uint8_t expected_length, UART_Message_Stats *stats) {
+	uint8_t message[255], length = 0;
+	TEST_CHECK(Get_UART_Message(fifo, message, &length, stats));
+	TEST_CHECK(length == expected_length);
+	TEST_CHECK(memcmp(message, expected, length) == 0);
+}
+
+/**
+ * @brief Builds a frame with one corrupted payload byte and no start byte after byte 0.
+ *
+ * The resynchronization after its failed check then drops exactly its bytes, with one
+ * bad checksum and no other candidate, so the counters are predictable.
+ */
+static void Test_BuildCorruptFrame(uint8_t *frame, uint8_t length) {
+	for (unsigned seed = 0; seed < 256; seed++) {
+		Test_BuildFrame(frame, length, (uint8_t)seed);
+		frame[2] ^= 0x01;
+		if (memchr(&frame[1], MESSAGE_START_BYTE, length - 1) == NULL) {
+			return;
+		}
+	}
+	TEST_CHECK(!"no corrupt frame without a second start byte");
+}
+
+/**
+ * Noise, a partial frame, an impossible length and a failed check, each followed by a
+ * valid frame, with the counters checked after every step.
+ */
+static void Test_Resync(void) {
+	static uint8_t storage[512];
+	static const uint8_t noise[] = { 0x01, 0x02, 0x03 };
+	static const uint8_t bad_length[] = { MESSAGE_START_BYTE, 0x01 };
+	uint8_t first[20], second[40], corrupt[24], message[255], length;
+	UART_Message_Stats stats;
+	FIFO_Buffer fifo;
+
+	FIFO_Init(&fifo, storage, sizeof(storage));
+	Reset_UART_Message_Stats(&stats);
+	Test_BuildFrame(first, sizeof(first), 1);
+	Test_BuildFrame(second, sizeof(second), MESSAGE_START_BYTE);	// Start bytes inside the payload
+	Test_BuildCorruptFrame(corrupt, sizeof(corrupt));
+
+	TEST_CHECK(!Get_UART_Message(&fifo, message, &length, &stats));	// Empty
+
+	// Leading noise is dropped up to the start byte
+	FIFO_PushBlock(&fifo, noise, sizeof(noise));
+	FIFO_PushBlock(&fifo, first, sizeof(first));
+	Test_Expect(&fifo, first, sizeof(first), &stats);
+	TEST_CHECK(stats.frames == 1 && stats.discarded_bytes == 3);
+
+	// A partial frame stays buffered until the rest arrives
+	FIFO_PushBlock(&fifo, second, 10);
+	TEST_CHECK(!Get_UART_Message(&fifo, message, &length, &stats));
+	TEST_CHECK(FIFO_Count(&fifo) == 10);
+	FIFO_PushBlock(&fifo, &second[10], sizeof(second) - 10);
+	Test_Expect(&fifo, second, sizeof(second), &stats);
+	TEST_CHECK(stats.frames == 2 && stats.discarded_bytes == 3);
+
+	// A length byte below the minimum drops the start byte, then the length byte as noise
+	FIFO_PushBlock(&fifo, bad_length, sizeof(bad_length));
+	FIFO_PushBlock(&fifo, first, sizeof(first));
+	Test_Expect(&fifo, first, sizeof(first), &stats);
+	TEST_CHECK(stats.frames == 3 && stats.bad_lengths == 1 && stats.discarded_bytes == 5);
+
+	// A failed check drops the corrupt frame and the next valid frame is found in the same call
+	FIFO_PushBlock(&fifo, corrupt, sizeof(corrupt));
+	FIFO_PushBlock(&fifo, first, sizeof(first));
+	Test_Expect(&fifo, first, sizeof(first), &stats);
+	TEST_CHECK(stats.frames == 4 && stats.bad_checksums == 1);
+	TEST_CHECK(stats.discarded_bytes == 5 + sizeof(corrupt));
+	TEST_CHECK(FIFO_IsEmpty(&fifo));
+
+	// Counting is optional
+	FIFO_PushBlock(&fifo, first, sizeof(first));
+	Test_Expect(&fifo, first, sizeof(first), NULL);
+	TEST_CHECK(stats.frames == 4);
+	FIFO_Deinit(&fifo);
+}
+
+/**
+ * Frames that straddle the wrap point of a buffer whose size is not a power of two.
+ */
+static void Test_Wrap(void) {
+	static uint8_t storage[100], skipped[100];
+	uint8_t frame[60];
+	UART_Message_Stats stats;
+	FIFO_Buffer fifo;
+
+	Reset_UART_Message_Stats(&stats);
+	Test_BuildFrame(frame, sizeof(frame), 7);
+	for (fifo_index_t offset = 41; offset < 100; offset += 6) {
+		FIFO_Init(&fifo, storage, sizeof(storage));
+		FIFO_PushBlock(&fifo, skipped, offset);	// Move head and tail so the frame wraps
+		FIFO_PopBlock(&fifo, skipped, offset);
+		FIFO_PushBlock(&fifo, frame, sizeof(frame));
+		Test_Expect(&fifo, frame, sizeof(frame), &stats);
+		TEST_CHECK(FIFO_IsEmpty(&fifo));
+		FIFO_Deinit(&fifo);
+	}
+	TEST_CHECK(stats.frames == 10 && stats.discarded_bytes == 0);
+}
+
+/**
+ * A long random stream of frames of every length through a small buffer, so frames
+ * wrap at every possible offset; every frame must come out intact and in order.
+ */
+static void Test_Stream(void) {
+	static uint8_t storage[100];
+	uint8_t frame[60], message[255], length;
+	unsigned sent = 0, received = 0;
+	UART_Message_Stats stats;
+	FIFO_Buffer fifo;
+
+	FIFO_Init(&fifo, storage, sizeof(storage));
+	Reset_UART_Message_Stats(&stats);
+	srand(2);
+	for (int step = 0; step < 20000; step++) {
+		uint8_t frame_length = (uint8_t)(UART_MESSAGE_MIN_LENGTH + rand() % (sizeof(frame) - UART_MESSAGE_MIN_LENGTH + 1));
+		Test_BuildFrame(frame, frame_length, (uint8_t)(sent * 3));
+		if (Add_UART_Message(&fifo, frame, frame_length)) {
+			sent++;
+		}
+		while (rand() % 2 && Get_UART_Message(&fifo, message, &length, &stats)) {
+			uint8_t expected[60];
+			Test_BuildFrame(expected, length, (uint8_t)(received * 3));
+			TEST_CHECK(memcmp(message, expected, length) == 0);
+			received++;
+		}
+	}
+	while (Get_UART_Message(&fifo, message, &length, &stats)) {
+		received++;
+	}
+	TEST_CHECK(received == sent && stats.frames == sent && stats.discarded_bytes == 0);
+	FIFO_Deinit(&fifo);
+}
+
+/**
+ * @brief Copies the frame described by a view into `message`.
+ */
+static void Test_ViewBytes(const UART_Message_View *view, uint8_t *message) {
+	TEST_CHECK(view->segments.length[0] + view->segments.length[1] == view->length);
+	memcpy(message, view->segments.data[0], view->segments.length[0]);
+	memcpy(&message[view->segments.length[0]], view->segments.data[1], view->segments.length[1]);
+}
+
+/**
+ * Views of a frame split by the wrap point, and releases that must be refused.
+ */
+static void Test_View(void) {
+	static uint8_t storage[100], other_storage[100], skipped[70];
+	uint8_t frame[60], next[30], empty[UART_MESSAGE_MIN_LENGTH], message[255], length;
+	UART_Message_View view, again;
+	UART_Message_Stats stats;
+	FIFO_Buffer fifo, other;
+
+	Reset_UART_Message_Stats(&stats);
+	Test_BuildFrame(frame, sizeof(frame), 9);
+	Test_BuildFrame(next, sizeof(next), 4);
+	Test_BuildFrame(empty, sizeof(empty), 0);
+
+	FIFO_Init(&fifo, storage, sizeof(storage));
+	FIFO_PushBlock(&fifo, skipped, sizeof(skipped));	// The frame starts 30 bytes before the end
+	FIFO_PopBlock(&fifo, skipped, sizeof(skipped));
+	FIFO_PushBlock(&fifo, frame, sizeof(frame));
+	FIFO_PushBlock(&fifo, next, sizeof(next));
+
+	// A wrapped frame comes back as two segments, and asking again gives the same view
+	TEST_CHECK(Get_UART_MessageView(&fifo, &view, &stats));
+	TEST_CHECK(view.length == sizeof(frame) && view.type == frame[2]);
+	TEST_CHECK(view.segments.length[0] == 30 && view.segments.length[1] == 30);
+	Test_ViewBytes(&view, message);
+	TEST_CHECK(memcmp(message, frame, sizeof(frame)) == 0);
+	TEST_CHECK(Get_UART_MessageView(&fifo, &again, NULL));
+	TEST_CHECK(again.segments.data[0] == view.segments.data[0] && again.length == view.length);
+
+	// A view is refused by a buffer holding the same bytes elsewhere
+	FIFO_Init(&other, other_storage, sizeof(other_storage));
+	FIFO_PushBlock(&other, frame, sizeof(frame));
+	TEST_CHECK(!Release_UART_Message(&other, &view, &stats));
+	TEST_CHECK(FIFO_Count(&other) == sizeof(frame));
+	FIFO_Deinit(&other);
+
+	// The first release removes the frame, a second one is refused and leaves the next frame
+	TEST_CHECK(Release_UART_Message(&fifo, &view, &stats));
+	TEST_CHECK(FIFO_Count(&fifo) == sizeof(next) && stats.frames == 1);
+	TEST_CHECK(!Release_UART_Message(&fifo, &view, &stats));
+	TEST_CHECK(FIFO_Count(&fifo) == sizeof(next) && stats.frames == 1);
+
+	// A view whose frame was consumed by a copying read is stale
+	TEST_CHECK(Get_UART_MessageView(&fifo, &view, &stats));
+	TEST_CHECK(view.segments.length[1] == 0 && view.type == next[2]);
+	Test_Expect(&fifo, next, sizeof(next), &stats);
+	FIFO_PushBlock(&fifo, frame, sizeof(frame));
+	TEST_CHECK(!Release_UART_Message(&fifo, &view, &stats));
+	TEST_CHECK(FIFO_Count(&fifo) == sizeof(frame) && stats.frames == 2);
+	Test_Expect(&fifo, frame, sizeof(frame), &stats);
+
+	// An empty payload has type 0
+	FIFO_PushBlock(&fifo, empty, sizeof(empty));
+	TEST_CHECK(Get_UART_MessageView(&fifo, &view, &stats));
+	TEST_CHECK(view.length == UART_MESSAGE_MIN_LENGTH && view.type == 0);
+	TEST_CHECK(Release_UART_Message(&fifo, &view, NULL));
+	TEST_CHECK(FIFO_IsEmpty(&fifo) && !Get_UART_MessageView(&fifo, &view, &stats));
+	TEST_CHECK(!Get_UART_Message(&fifo, message, &length, &stats));
+	TEST_CHECK(stats.frames == 3 && stats.discarded_bytes == 0);
+	FIFO_Deinit(&fifo);
+}
+
+int main(void) {
+	uint8_t frame[UART_MESSAGE_MIN_LENGTH];
+
+	TEST_CHECK(!Seal_UART_Message(frame, UART_MESSAGE_MIN_LENGTH - 1));
+	TEST_CHECK(Seal_UART_Message(frame, UART_MESSAGE_MIN_LENGTH));	// Empty payload
+	TEST_CHECK(frame[0] == MESSAGE_START_BYTE && frame[1] == UART_MESSAGE_MIN_LENGTH);
+
+	Test_Resync();
+	Test_Wrap();
+	Test_Stream();
+	Test_View();
+	puts("ok");
+	return 0;
+}
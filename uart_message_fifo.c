@@ -6,6 +6,50 @@
  */ 
 
 #include "uart_message_fifo.h"
+#include "fifo_buffer_inline.h"
+#include "fifo_simd.h"
+#include "fifo_crc.h"
+#include <string.h>
+
+/**
+ * @brief Computes the integrity check value over the covered bytes of a frame.
+ * 
+ * @param segments Bytes 2 to `length - UART_MESSAGE_CHECK_SIZE - 1` of the frame, in up to two pieces.
+ * @return The XOR, CRC-16 or CRC-32C selected by UART_MESSAGE_INTEGRITY.
+ */
+static uint32_t UART_Message_Check(const FIFO_Segments *segments) {
+#if UART_MESSAGE_INTEGRITY == UART_INTEGRITY_XOR
+	return FIFO_SIMD_Xor(segments->data[0], segments->length[0]) ^ FIFO_SIMD_Xor(segments->data[1], segments->length[1]);
+#elif UART_MESSAGE_INTEGRITY == UART_INTEGRITY_CRC16
+	uint16_t crc = FIFO_CRC16_Update(FIFO_CRC16_INITIAL, segments->data[0], segments->length[0]);
+	return FIFO_CRC16_Update(crc, segments->data[1], segments->length[1]);
+#else
+	uint32_t crc = FIFO_CRC32C_Update(FIFO_CRC32C_INITIAL, segments->data[0], segments->length[0]);
+	return FIFO_CRC32C_Final(FIFO_CRC32C_Update(crc, segments->data[1], segments->length[1]));
+#endif
+}
+
+/**
+ * @brief Fills in the start byte, the length and the check bytes of a frame.
+ * 
+ * @param message Frame of `length` bytes whose payload, from byte 2, is already written.
+ * @param length Total frame length, at least UART_MESSAGE_MIN_LENGTH.
+ * @return true if the frame was sealed, false if it is too short.
+ */
+bool Seal_UART_Message(uint8_t *message, uint8_t length) {
+	if (length < UART_MESSAGE_MIN_LENGTH) {
+		return false;
+	}
+	
+	FIFO_Segments segments = { { &message[2], NULL }, { length - 2 - UART_MESSAGE_CHECK_SIZE, 0 } };
+	uint32_t check = UART_Message_Check(&segments);
+	message[0] = MESSAGE_START_BYTE;
+	message[1] = length;
+	for (uint8_t i = 0; i < UART_MESSAGE_CHECK_SIZE; i++) {
+		message[length - UART_MESSAGE_CHECK_SIZE + i] = (uint8_t)(check >> (8 * i)); // Little-endian
+	}
+	return true;
+}
 
 /**
  * @brief Adds a complete UART message to the FIFO buffer.
@@ -16,60 +60,200 @@
  * @return true if the message was successfully added, false if the buffer lacks space.
  */
 bool Add_UART_Message(FIFO_Buffer *fifo, const uint8_t *message, uint8_t length) {
-	if (length < 3 || BUFFER_SIZE - fifo->count < length) {
+	if (length < UART_MESSAGE_MIN_LENGTH || fifo->size - FIFO_Count(fifo) < length) {
 		return false; // Message too short or not enough space
 	}
 	
-	for (uint8_t i = 0; i < length; i++) {
-		if (!FIFO_Push(fifo, message[i])) {
-			return false;
+	// Space was checked above, so the whole frame goes in with one block copy
+	return FIFO_PushBlock(fifo, message, length) == length;
+}
+
+/**
+ * @brief Drops bytes from the front of the FIFO buffer while resynchronizing.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param length Number of bytes to drop, at most the current count.
+ * @param stats Parser counters to update.
+ */
+static void UART_Message_Discard(FIFO_Buffer *fifo, fifo_index_t length, UART_Message_Stats *stats) {
+	FIFO_ReadRelease(fifo, length);
+	stats->discarded_bytes += length;
+}
+
+/**
+ * @brief Checks the integrity of a frame while it is still in the FIFO buffer.
+ * 
+ * The check value is computed directly over the one or two ring segments holding the
+ * frame and compared with the check bytes at its end.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param message_length Length of the frame at the front of the buffer, all of it buffered.
+ * @return true if the check bytes match.
+ */
+static bool UART_Message_Verify(FIFO_Buffer *fifo, uint8_t message_length) {
+	FIFO_Segments segments;
+	uint8_t stored[UART_MESSAGE_CHECK_SIZE];
+	uint32_t expected = 0;
+	
+	FIFO_PeekSegments(fifo, 2, message_length - 2 - UART_MESSAGE_CHECK_SIZE, &segments);
+	FIFO_PeekBlock(fifo, message_length - UART_MESSAGE_CHECK_SIZE, stored, UART_MESSAGE_CHECK_SIZE);
+	for (uint8_t i = 0; i < UART_MESSAGE_CHECK_SIZE; i++) {
+		expected |= (uint32_t)stored[i] << (8 * i);
+	}
+	return UART_Message_Check(&segments) == expected;
+}
+
+/**
+ * @brief Brings the next complete and valid frame to the front of the FIFO buffer.
+ * 
+ * The frame is inspected with peeks, and its integrity check is computed in place over
+ * the ring, so a frame that is still arriving is left untouched for the next call.
+ * Bytes before a start byte, and the start byte of a candidate with an impossible
+ * length (below UART_MESSAGE_MIN_LENGTH or above the buffer size) or a failed integrity
+ * check, are dropped and the search continues at the next MESSAGE_START_BYTE.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param stats Parser counters to update, or NULL.
+ * @return Length of the valid frame now at the front of the buffer, or 0 if none is buffered yet.
+ */
+static uint8_t UART_Message_Find(FIFO_Buffer *fifo, UART_Message_Stats *stats) {
+	UART_Message_Stats ignored;
+	if (stats == NULL) {
+		stats = &ignored;	// Counting into a local keeps the loop free of NULL checks
+	}
+	for (;;) {
+		fifo_index_t count = FIFO_CountInline(fifo);
+		uint8_t start_byte;
+		if (!FIFO_PeekInline(fifo, 0, &start_byte)) {
+			return 0; // Buffer is empty
 		}
+		if (start_byte != MESSAGE_START_BYTE) {
+			fifo_index_t start = FIFO_FindByte(fifo, 1, MESSAGE_START_BYTE);	// Vectorized scan over the ring
+			UART_Message_Discard(fifo, start, stats);	// Noise before the next candidate frame
+			count -= start;
+		}
+		
+		uint8_t message_length;
+		if (!FIFO_PeekInline(fifo, 1, &message_length)) {
+			return 0; // No start byte yet, or the length has not arrived
+		}
+		if (message_length < UART_MESSAGE_MIN_LENGTH || message_length > fifo->size) {
+			stats->bad_lengths++;
+			UART_Message_Discard(fifo, 1, stats);	// Not a frame, look for the next start byte
+			continue;
+		}
+		if (count < message_length) {
+			return 0; // Incomplete message, keep it for the next call
+		}
+		
+		if (!UART_Message_Verify(fifo, message_length)) {
+			stats->bad_checksums++;
+			UART_Message_Discard(fifo, 1, stats);	// The frame may start later, e.g. inside this payload
+			continue;
+		}
+		
+		return message_length;
 	}
-	return true;
 }
 
 /**
  * @brief Retrieves a complete UART message from the FIFO buffer.
  * 
+ * Only a frame that is complete and passes its integrity check is copied out and
+ * removed from the buffer; noise and invalid frames before it are dropped and counted
+ * in `stats`.
+ * 
  * @param fifo Pointer to the FIFO buffer.
- * @param message Pointer to an array to store the retrieved message.
+ * @param message Pointer to an array to store the retrieved message, at least 255 bytes long.
  * @param length Pointer to store the length of the retrieved message.
- * @return true if a complete message was retrieved, false if the buffer is empty or corrupted data.
+ * @param stats Counters of this FIFO buffer's parser, or NULL to not count.
+ * @return true if a complete message was retrieved, false if no complete valid message is buffered yet.
  */
-bool Get_UART_Message(FIFO_Buffer *fifo, uint8_t *message, uint8_t *length) {
-	if (FIFO_IsEmpty(fifo)) {
-		return false; // Buffer is empty
+bool Get_UART_Message(FIFO_Buffer *fifo, uint8_t *message, uint8_t *length, UART_Message_Stats *stats) {
+	uint8_t message_length = UART_Message_Find(fifo, stats);
+	if (message_length == 0) {
+		return false;
 	}
 	
-	uint8_t start_byte;
-	if (!FIFO_Pop(fifo, &start_byte) || start_byte != MESSAGE_START_BYTE) {
-		return false; // Invalid start byte
+	FIFO_PeekBlock(fifo, 0, message, message_length);
+	FIFO_ReadRelease(fifo, message_length);
+	if (stats != NULL) {
+		stats->frames++;
 	}
-	
-	uint8_t message_length;
-	if (!FIFO_Pop(fifo, &message_length) || message_length < 3) {
-		return false; // Invalid length
-	}
-	
 	*length = message_length;
-	message[0] = MESSAGE_START_BYTE;
-	message[1] = message_length;
-	
-	uint8_t checksum = 0;
-	for (uint8_t i = 2; i < message_length; i++) {
-		if (!FIFO_Pop(fifo, &message[i])) {
-			return false; // Incomplete message
-		}
-		checksum ^= message[i];
+	return true;
+}
+
+/**
+ * @brief Retrieves a complete UART message without copying it out of the FIFO buffer.
+ * 
+ * Validates the next frame like Get_UART_Message(), but leaves it in the ring and
+ * describes it in place, so handlers can parse it with no copy. The frame occupies one
+ * segment, or two when it crosses the wrap point (never with a mirrored buffer). The
+ * view stays valid until Release_UART_Message() is called. The producer may keep adding
+ * bytes meanwhile, but must not overwrite old data: neither FIFO_PushOverwrite() nor
+ * FIFO_Push() with overwrite enabled (FIFO_SetOverwrite()) may be used on this buffer
+ * while a view is held, as a push into a full buffer would drop the frame's first
+ * bytes. Calling this again before releasing returns the same frame.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param view Receives the frame segments, length and type.
+ * @param stats Counters of this FIFO buffer's parser, or NULL to not count.
+ * @return true if a complete message is available, false if no complete valid message is buffered yet.
+ */
+bool Get_UART_MessageView(FIFO_Buffer *fifo, UART_Message_View *view, UART_Message_Stats *stats) {
+	uint8_t message_length = UART_Message_Find(fifo, stats);
+	if (message_length == 0) {
+		return false;
 	}
 	
-	if (checksum != 0) {
-		return false; // Invalid checksum
+	FIFO_PeekSegments(fifo, 0, message_length, &view->segments);
+	view->length = message_length;
+	view->type = 0;
+	if (message_length > UART_MESSAGE_MIN_LENGTH) {
+		FIFO_PeekInline(fifo, 2, &view->type);
 	}
-	
 	return true;
 }
 
+/**
+ * @brief Removes a frame returned by Get_UART_MessageView() from the FIFO buffer.
+ * 
+ * The view must still describe the frame at the front of this buffer: it must start at
+ * the current tail, and the start byte and length byte found there must match it.
+ * Otherwise nothing is removed, so releasing a view twice, releasing it on another
+ * buffer or after the frame was overwritten cannot drop unrelated bytes.
+ * 
+ * @param fifo Pointer to the FIFO buffer.
+ * @param view The view filled in by the last successful Get_UART_MessageView() call.
+ * @param stats Counters of this FIFO buffer's parser, or NULL to not count.
+ * @return true if the frame was removed, false if the view does not match the front of the buffer.
+ */
+bool Release_UART_Message(FIFO_Buffer *fifo, const UART_Message_View *view, UART_Message_Stats *stats) {
+	uint8_t start_byte, message_length;
+	if (view->segments.data[0] != &fifo->buffer[FIFO_TailIndex(fifo)] ||
+		!FIFO_PeekInline(fifo, 0, &start_byte) || start_byte != MESSAGE_START_BYTE ||
+		!FIFO_PeekInline(fifo, 1, &message_length) || message_length != view->length) {
+		return false; // Stale view, or one taken from another buffer
+	}
+	if (!FIFO_ReadRelease(fifo, view->length)) {
+		return false; // Fewer bytes buffered than the view covers
+	}
+	if (stats != NULL) {
+		stats->frames++;
+	}
+	return true;
+}
+
+/**
+ * @brief Clears parser counters before their first use or to start a new measurement.
+ * 
+ * @param stats Counters to clear.
+ */
+void Reset_UART_Message_Stats(UART_Message_Stats *stats) {
+	memset(stats, 0, sizeof(*stats));
+}
+
 /*
 Example Usage.
 
@@ -84,6 +268,7 @@ Example Usage.
 #define BAUD_PRESCALE ((F_CPU / (UART_BAUD_RATE * 16UL)) - 1)
 
 FIFO_Buffer uart_fifo;  // Define the UART FIFO buffer
+UART_Message_Stats uart_stats;  // Parser counters for uart_fifo
 
 // Initializes UART for AVR128DA64.
 void UART_Init(void) {
@@ -121,19 +306,19 @@ void ProcessMessage(const uint8_t *message, uint8_t length) {
 
 // Main program loop.
 int main(void) {
-    // Initialize the FIFO with a statically allocated buffer
+    // Initialize the FIFO with a statically allocated buffer
     FIFO_Init(&fifo, uart_fifo, BUFFER_SIZE);
 	// Initialize UART
     UART_Init(); 
 	// Enable global interrupts          
     sei();                 
 
-    uint8_t message[64];   // Buffer to hold a single UART message
+    uint8_t message[255];  // Buffer to hold a single UART message, up to 255 bytes
     uint8_t length;        // Length of the retrieved message
 
     while (1) {
         // Check if a complete message can be retrieved
-        if (Get_UART_Message(&uart_fifo, message, &length)) {
+        if (Get_UART_Message(&uart_fifo, message, &length, &uart_stats)) {
             ProcessMessage(message, length);  // Process the message
         }
     }
@@ -14,8 +14,63 @@
 #define MESSAGE_START_BYTE 0xAA  // Example start byte
 #define BUFFER_SIZE			128
 
+/*
+ * Frame integrity check, selected at build time with -DUART_MESSAGE_INTEGRITY=<value>:
+ *
+ * - UART_INTEGRITY_XOR:    one trailing byte, the XOR of bytes 2 to length - 2 (default)
+ * - UART_INTEGRITY_CRC16:  CRC-16-CCITT of bytes 2 to length - 3, little-endian in the
+ *                          last 2 bytes
+ * - UART_INTEGRITY_CRC32C: CRC-32C of bytes 2 to length - 5, little-endian in the last
+ *                          4 bytes
+ *
+ * Senders fill in the check bytes with Seal_UART_Message(). The CRCs are computed over
+ * the ring in place, see fifo_crc.h.
+ */
+#define UART_INTEGRITY_XOR		0
+#define UART_INTEGRITY_CRC16	1
+#define UART_INTEGRITY_CRC32C	2
+
+#ifndef UART_MESSAGE_INTEGRITY
+#define UART_MESSAGE_INTEGRITY UART_INTEGRITY_XOR
+#endif
+
+#if UART_MESSAGE_INTEGRITY == UART_INTEGRITY_XOR
+#define UART_MESSAGE_CHECK_SIZE		1
+#elif UART_MESSAGE_INTEGRITY == UART_INTEGRITY_CRC16
+#define UART_MESSAGE_CHECK_SIZE		2
+#elif UART_MESSAGE_INTEGRITY == UART_INTEGRITY_CRC32C
+#define UART_MESSAGE_CHECK_SIZE		4
+#else
+#error "Unknown UART_MESSAGE_INTEGRITY"
+#endif
+
+#define UART_MESSAGE_MIN_LENGTH		(2 + UART_MESSAGE_CHECK_SIZE)	///< Start byte, length and check bytes
+
+/**
+ * Parser counters, owned by the caller and passed to Get_UART_Message(),
+ * Get_UART_MessageView() and Release_UART_Message(). Keep one per FIFO buffer.
+ */
+typedef struct {
+	uint32_t frames;				///< Valid frames consumed by Get_UART_Message() or Release_UART_Message()
+	uint32_t discarded_bytes;		///< Bytes dropped while searching for the next valid frame
+	uint32_t bad_lengths;			///< Candidate frames rejected for their length byte
+	uint32_t bad_checksums;			///< Candidate frames rejected by the integrity check
+} UART_Message_Stats;
+
+/**
+ * A valid frame left in place in the FIFO buffer, see Get_UART_MessageView().
+ */
+typedef struct {
+	FIFO_Segments segments;			///< The whole frame, start byte included, in one or two pieces
+	uint8_t length;					///< Total frame length
+	uint8_t type;					///< First payload byte (byte 2), 0 if the payload is empty
+} UART_Message_View;
 
+bool Seal_UART_Message(uint8_t *message, uint8_t length);
 bool Add_UART_Message(FIFO_Buffer *fifo, const uint8_t *message, uint8_t length);
-bool Get_UART_Message(FIFO_Buffer *fifo, uint8_t *message, uint8_t *length);
+bool Get_UART_Message(FIFO_Buffer *fifo, uint8_t *message, uint8_t *length, UART_Message_Stats *stats);
+bool Get_UART_MessageView(FIFO_Buffer *fifo, UART_Message_View *view, UART_Message_Stats *stats);
+bool Release_UART_Message(FIFO_Buffer *fifo, const UART_Message_View *view, UART_Message_Stats *stats);
+void Reset_UART_Message_Stats(UART_Message_Stats *stats);
 
 #endif /* UART_MESSAGE_FIFO_H_ */
\ No newline at end of file